@@ -8,26 +8,146 @@
 #ifndef SRC_DLX_HPP_
 #define SRC_DLX_HPP_
 
-#include "DLNode.hpp"
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
 class DLX {
 public:
-  DLX(std::vector<std::vector<int>> matrix);
-  ~DLX();
+  // Search statistics. Only nodes is always counted, the rest needs a build
+  // with DLX_STATISTICS defined (cmake -DDLX_STATISTICS=ON).
+  struct Statistics {
+    uint64_t nodes = 0;        // search nodes entered
+    uint64_t backtracks = 0;   // chosen rows taken back
+    uint64_t covers = 0;       // columns covered
+    uint64_t uncovers = 0;     // columns uncovered
+    uint64_t link_updates = 0; // nodes unlinked or relinked
+    // deepest level reached, counted from the subtree a thread was given in
+    // a parallel search
+    uint32_t max_depth = 0;
+    // branching[k] is the number of nodes that branched on a column of k rows
+    std::vector<uint64_t> branching{};
+  };
+#ifdef DLX_STATISTICS
+  static const bool statistics_enabled{true};
+#else
+  static const bool statistics_enabled{false};
+#endif
 
+  DLX(const std::vector<std::vector<int>> &matrix); // dense 0/1 matrix
+  // Sparse matrix, each row lists the column indices of its 1s. The last
+  // num_secondary columns are secondary: a solution covers them at most once
+  // instead of exactly once.
+  DLX(int num_columns, const std::vector<std::vector<int>> &rows,
+      int num_secondary = 0);
+
+  enum class Status { Solved, Unsolvable, Suspended };
+
+  // Runs the search for at most max_nodes search nodes (0 means no limit).
+  // A Suspended search resumes where it stopped on the next call, and calling
+  // again after Solved continues with the next solution.
+  Status search(uint64_t max_nodes = 0);
   bool solve();
+  // Finds one solution using num_threads threads (0 means one per core).
+  // Every thread searches its own copy of the matrix, idle threads are fed
+  // untried rows split off the top of a busy thread's search, and the first
+  // solution found stops all of them. Unlike search(), it cannot be resumed.
+  bool solve(unsigned num_threads);
+  // As above, polling stop with the number of nodes searched by all threads
+  // every so often. Returns Suspended if stop returned true.
+  Status solve(unsigned num_threads,
+               const std::function<bool(uint64_t)> &stop);
+  // counts the remaining solutions, stopping at limit (0 means count all)
+  uint64_t count(uint64_t limit = 0);
+  // passes the rows of each remaining solution to sink until it returns
+  // false, returns the number of solutions passed
+  uint64_t
+  enumerate(const std::function<bool(const std::vector<int> &)> &sink);
   std::vector<int> getSolution();
+  uint64_t getNodeCount();
+  Statistics getStatistics();
+
+  // Puts a row into every solution and restarts the search. Returns false
+  // if the row clashes with a row already selected. getSolution() only
+  // reports the rows chosen by the search.
+  bool select(int row);
+  // Takes a row out of the matrix, so that no solution contains it, and
+  // restarts the search. Returns false if it is out already, e.g. because it
+  // clashes with a selected row.
+  bool remove(int row);
+  void unselect(); // undo the last select() or remove(), restarts the search
+  void restart();  // drop the search state, keeps the selected rows
+  void reset();    // back to the matrix as constructed
 
 private:
+  // Node 0 is the root, column headers are 1..num_columns followed by the
+  // root of the secondary columns, then the matrix nodes.
+  static const int32_t root{0};
+
+  enum class Step { Enter, TryRow, Backtrack, Exhausted };
+  struct Frame {
+    int32_t column; // column covered at this depth
+    int32_t row;    // node of the row currently chosen in that column
+    int32_t end;    // node after the last row to try, normally the column
+  };
+  struct ParallelState;
+
   std::vector<int> solution{};
-  DLNode *head;
-  std::vector<DLNode *> nodes{};
+  std::vector<int32_t> row_nodes{}; // first node of each row, -1 if empty
+  // row nodes put in by select(), and ~node for the rows taken out by
+  // remove(), in the order they were made
+  std::vector<int32_t> selected{};
+  // decision stack, sized for the deepest possible search up front
+  std::vector<Frame> stack{};
+  int32_t depth{0};
+  Step step{Step::Enter};
+  uint64_t node_count{0};
+  Statistics statistics{};
+
+  // Active columns bucketed by size: one bit set over the columns for every
+  // size, so the smallest column with the lowest index is found without
+  // walking the column list.
+  std::vector<uint64_t> buckets{};
+  int32_t bucket_words{};
+  int32_t min_size{0}; // no active column has fewer nodes
+
+  int32_t num_nodes{};
+  int32_t num_primary{};
+  int32_t secondary_root{};
+  // Nodes are indices into one struct-of-arrays block: the left links of all
+  // nodes come first, then the right links, up, down, column and row. The row
+  // slot of a column header holds the number of nodes in that column.
+  std::vector<int32_t> links{};
+
+  int32_t &left(int32_t node) { return links[node]; }
+  int32_t &right(int32_t node) { return links[num_nodes + node]; }
+  int32_t &up(int32_t node) { return links[2 * num_nodes + node]; }
+  int32_t &down(int32_t node) { return links[3 * num_nodes + node]; }
+  int32_t &column(int32_t node) { return links[4 * num_nodes + node]; }
+  int32_t &row(int32_t node) { return links[5 * num_nodes + node]; }
+  int32_t &columnSize(int32_t col) { return row(col); }
+
+  void hRemove(int32_t node);  // remove horizontally
+  void vRemove(int32_t node);  // remove vertically
+  void hRestore(int32_t node); // restore horizontally
+  void vRestore(int32_t node); // restore vertically
+  void addToBucket(int32_t col);
+  void removeFromBucket(int32_t col);
 
-  void cover(DLNode *node);
-  void uncover(DLNode *node);
-  DLNode *chooseNextColumn();
+  void cover(int32_t node);
+  void uncover(int32_t node);
+  void selectRow(int32_t node);   // cover every column of the row
+  void unselectRow(int32_t node); // undo selectRow
+  void popSelected();             // undo the last select() or remove()
+  // no node of the row has been unlinked, and all its columns are active
+  bool rowIsFree(int32_t node);
+  void work(ParallelState &state);
+  void donate(ParallelState &state, const std::vector<int32_t> &prefix);
+  bool isActive(int32_t col) { return right(left(col)) == col; }
+  int32_t chooseNextColumn();
+  static std::vector<std::vector<int>>
+  toRowLists(const std::vector<std::vector<int>> &matrix);
 };
 
 #endif /* SRC_DLX_HPP_ */
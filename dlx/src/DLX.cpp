@@ -30,122 +30,412 @@
  */
 
 #include "DLX.hpp"
+#include <algorithm>
+#include <cassert>
 
-DLX::DLX(std::vector<std::vector<int>> matrix) {
-  const int col_size = matrix[0].size();
-  head = new DLNode{};
-  nodes.push_back(head);
-  std::vector<DLNode *> temp_col_ptr{};
-  std::vector<DLNode *> head_col_ptr{};
-  DLNode *node_ptr = head;
-  // create column node
-  for (int i = 0; i < col_size; ++i) {
-    auto *node = new DLNode{i};
-    nodes.push_back(node);
-    node_ptr->setRight(node);
-    node->setLeft(node_ptr);
-    node_ptr = node;
-    temp_col_ptr.push_back(node);
-    head_col_ptr.push_back(node);
+#ifdef DLX_STATISTICS
+#define DLX_STAT(expr) (expr)
+#else
+#define DLX_STAT(expr) ((void)0)
+#endif
+
+namespace {
+int lowestBit(uint64_t word) {
+  assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  // de Bruijn multiplication
+  static const int index[64] = {
+      0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6};
+  return index[((word & (~word + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+#endif
+}
+} // namespace
+
+DLX::DLX(const std::vector<std::vector<int>> &matrix)
+    : DLX(matrix.empty() ? 0 : static_cast<int>(matrix[0].size()),
+          toRowLists(matrix)) {}
+
+DLX::DLX(int num_columns, const std::vector<std::vector<int>> &rows,
+         int num_secondary) {
+  assert(num_secondary >= 0 && num_secondary <= num_columns);
+  num_primary = num_columns - num_secondary;
+  secondary_root = num_columns + 1;
+  num_nodes = num_columns + 2;
+  for (auto &r : rows)
+    num_nodes += static_cast<int32_t>(r.size());
+  links.resize(6 * static_cast<size_t>(num_nodes));
+
+  // primary column headers are listed from root, secondary ones from
+  // secondary_root so that the search never picks them
+  for (int32_t i = 0; i <= secondary_root; ++i) {
+    up(i) = down(i) = column(i) = i;
+    columnSize(i) = 0;
   }
-  node_ptr->setRight(head);
-  head->setLeft(node_ptr);
+  auto link_headers = [this](int32_t list, int32_t first, int32_t last) {
+    int32_t prev{list};
+    for (int32_t col = first; col <= last; ++col) {
+      right(prev) = col;
+      left(col) = prev;
+      prev = col;
+    }
+    right(prev) = list;
+    left(list) = prev;
+  };
+  link_headers(root, 1, num_primary);
+  link_headers(secondary_root, num_primary + 1, num_columns);
 
-  // create nodes for matrix
-  const int row_size = matrix.size();
+  // create nodes for matrix, row by row
+  int32_t node{secondary_root + 1};
+  const int row_size = rows.size();
+  row_nodes.resize(row_size);
   for (int i = 0; i < row_size; ++i) {
-    DLNode *temp_row_ptr{nullptr}, *head_row_ptr{nullptr};
-    for (int j = 0; j < col_size; ++j) {
-      if (matrix[i][j] == 1) {
-        auto *node = new DLNode{i, j, head_col_ptr[j]};
-        nodes.push_back(node);
-        temp_col_ptr[j]->setDown(node);
-        node->setUp(temp_col_ptr[j]);
-        temp_col_ptr[j] = node;
-        if (temp_row_ptr) {
-          temp_row_ptr->setRight(node);
-          node->setLeft(temp_row_ptr);
-          temp_row_ptr = node;
-        } else
-          temp_row_ptr = head_row_ptr = node;
-      }
+    const int32_t first{node};
+    row_nodes[i] = rows[i].empty() ? -1 : first;
+    for (int j : rows[i]) {
+      assert(j >= 0 && j < num_columns);
+      const int32_t col{j + 1};
+      // append at the bottom of the column
+      up(node) = up(col);
+      down(node) = col;
+      down(up(col)) = node;
+      up(col) = node;
+      column(node) = col;
+      row(node) = i;
+      ++columnSize(col);
+      left(node) = node - 1;
+      right(node) = node + 1;
+      ++node;
     }
-    temp_row_ptr->setRight(head_row_ptr);
-    head_row_ptr->setLeft(temp_row_ptr);
+    if (node == first)
+      continue; // empty row can never be chosen
+    left(first) = node - 1;
+    right(node - 1) = first;
   }
-  for (int i = 0; i < col_size; ++i) {
-    temp_col_ptr[i]->setDown(head_col_ptr[i]);
-    head_col_ptr[i]->setUp(temp_col_ptr[i]);
+  // every level of the search covers at least one primary column
+  stack.resize(num_primary + 1);
+
+  int32_t max_size{0};
+  for (int32_t col = 1; col <= num_primary; ++col)
+    max_size = std::max(max_size, columnSize(col));
+  bucket_words = num_primary / 64 + 1;
+  buckets.resize(static_cast<size_t>(max_size + 1) * bucket_words);
+  min_size = max_size;
+  for (int32_t col = 1; col <= num_primary; ++col)
+    addToBucket(col);
+}
+
+std::vector<std::vector<int>>
+DLX::toRowLists(const std::vector<std::vector<int>> &matrix) {
+  std::vector<std::vector<int>> rows(matrix.size());
+  for (size_t i = 0; i < matrix.size(); ++i) {
+    for (size_t j = 0; j < matrix[i].size(); ++j) {
+      if (matrix[i][j] == 1)
+        rows[i].push_back(static_cast<int>(j));
+    }
   }
+  return rows;
+}
+
+void DLX::hRemove(int32_t node) {
+  assert(right(left(node)) == node);
+  assert(left(right(node)) == node);
+  right(left(node)) = right(node);
+  left(right(node)) = left(node);
+  DLX_STAT(++statistics.link_updates);
 }
 
-DLX::~DLX() {
-  for (auto node : nodes) {
-    delete node;
+void DLX::vRemove(int32_t node) {
+  assert(up(down(node)) == node);
+  assert(down(up(node)) == node);
+  up(down(node)) = up(node);
+  down(up(node)) = down(node);
+  DLX_STAT(++statistics.link_updates);
+  const int32_t col{column(node)};
+  if (col > num_primary) {
+    --columnSize(col);
+    return;
   }
+  removeFromBucket(col);
+  --columnSize(col);
+  addToBucket(col);
 }
 
-void DLX::cover(DLNode *node) {
-  DLNode *column = node->getColumnNode();
-  column->hRemove();
-  for (auto *row = column->getDown(); row != column; row = row->getDown()) {
-    for (auto rightNode = row->getRight(); rightNode != row;
-         rightNode = rightNode->getRight()) {
-      rightNode->vRemove();
+void DLX::hRestore(int32_t node) {
+  left(right(node)) = node;
+  right(left(node)) = node;
+  DLX_STAT(++statistics.link_updates);
+}
+
+void DLX::vRestore(int32_t node) {
+  down(up(node)) = node;
+  up(down(node)) = node;
+  DLX_STAT(++statistics.link_updates);
+  const int32_t col{column(node)};
+  if (col > num_primary) {
+    ++columnSize(col);
+    return;
+  }
+  removeFromBucket(col);
+  ++columnSize(col);
+  addToBucket(col);
+}
+
+void DLX::addToBucket(int32_t col) {
+  const int32_t size{columnSize(col)};
+  buckets[size * bucket_words + col / 64] |= uint64_t{1} << (col % 64);
+  if (size < min_size)
+    min_size = size;
+}
+
+void DLX::removeFromBucket(int32_t col) {
+  const int32_t size{columnSize(col)};
+  assert(buckets[size * bucket_words + col / 64] & (uint64_t{1} << (col % 64)));
+  buckets[size * bucket_words + col / 64] &= ~(uint64_t{1} << (col % 64));
+}
+
+void DLX::cover(int32_t node) {
+  const int32_t col{column(node)};
+  DLX_STAT(++statistics.covers);
+  hRemove(col);
+  if (col <= num_primary)
+    removeFromBucket(col);
+  for (int32_t r = down(col); r != col; r = down(r)) {
+    for (int32_t right_node = right(r); right_node != r;
+         right_node = right(right_node)) {
+      vRemove(right_node);
     }
   }
 }
 
-void DLX::uncover(DLNode *node) {
-  DLNode *column = node->getColumnNode();
-  for (auto *row = column->getUp(); row != column; row = row->getUp()) {
-    for (auto leftNode = row->getLeft(); leftNode != row;
-         leftNode = leftNode->getLeft()) {
-      leftNode->vRestore();
+void DLX::uncover(int32_t node) {
+  const int32_t col{column(node)};
+  DLX_STAT(++statistics.uncovers);
+  for (int32_t r = up(col); r != col; r = up(r)) {
+    for (int32_t left_node = left(r); left_node != r;
+         left_node = left(left_node)) {
+      vRestore(left_node);
     }
   }
-  column->hRestore();
-}
-
-DLNode *DLX::chooseNextColumn() {
-  int min_num{0}; // minimum number of node in a column
-  DLNode *column = head->getRight(), *next_col = column;
-  while (column != head) {
-    int node_num = column->getNumberOfNode();
-    if (node_num == 0)
-      return head;
-    else if (node_num == 1)
-      return column;
-    else if (node_num < min_num || min_num == 0) {
-      min_num = node_num;
-      next_col = column;
+  hRestore(col);
+  if (col <= num_primary)
+    addToBucket(col);
+}
+
+bool DLX::select(int r) {
+  assert(r >= 0 && r < static_cast<int>(row_nodes.size()));
+  restart();
+  const int32_t node{row_nodes[r]};
+  if (node < 0 || !rowIsFree(node))
+    return false;
+  selectRow(node);
+  selected.push_back(node);
+  statistics = Statistics{}; // only the search is counted
+  return true;
+}
+
+bool DLX::remove(int r) {
+  assert(r >= 0 && r < static_cast<int>(row_nodes.size()));
+  restart();
+  const int32_t node{row_nodes[r]};
+  if (node < 0 || !rowIsFree(node))
+    return false;
+  int32_t n{node};
+  do {
+    vRemove(n);
+    n = right(n);
+  } while (n != node);
+  selected.push_back(~node);
+  statistics = Statistics{};
+  return true;
+}
+
+void DLX::unselect() {
+  restart();
+  if (selected.empty())
+    return;
+  popSelected();
+  statistics = Statistics{};
+}
+
+bool DLX::rowIsFree(int32_t node) {
+  int32_t n{node};
+  do {
+    if (!isActive(column(n)) || down(up(n)) != n)
+      return false;
+    n = right(n);
+  } while (n != node);
+  return true;
+}
+
+void DLX::popSelected() {
+  const int32_t node{selected.back()};
+  selected.pop_back();
+  if (node >= 0) {
+    unselectRow(node);
+    return;
+  }
+  // a removed row, relinked in the reverse order
+  int32_t n{~node};
+  do {
+    n = left(n);
+    vRestore(n);
+  } while (n != ~node);
+}
+
+void DLX::restart() {
+  if (step == Step::TryRow) {
+    // the row of the top frame is not in place yet
+    uncover(stack[--depth].column);
+  }
+  while (depth > 0) {
+    const Frame &frame = stack[--depth];
+    unselectRow(frame.row);
+  }
+  step = Step::Enter;
+  solution.clear();
+  node_count = 0;
+  statistics = Statistics{};
+}
+
+void DLX::reset() {
+  restart();
+  while (!selected.empty())
+    popSelected();
+  statistics = Statistics{};
+}
+
+void DLX::selectRow(int32_t node) {
+  cover(node);
+  for (int32_t right_node = right(node); right_node != node;
+       right_node = right(right_node))
+    cover(right_node);
+}
+
+void DLX::unselectRow(int32_t node) {
+  for (int32_t left_node = left(node); left_node != node;
+       left_node = left(left_node))
+    uncover(left_node);
+  uncover(node);
+}
+
+int32_t DLX::chooseNextColumn() {
+  // only called while some column is active, so a bucket is not empty
+  for (;; ++min_size) {
+    const uint64_t *words{&buckets[min_size * bucket_words]};
+    for (int32_t word = 0; word < bucket_words; ++word) {
+      if (words[word] == 0)
+        continue;
+      if (min_size == 0)
+        return root; // there is a column with no node
+      return word * 64 + lowestBit(words[word]);
+    }
+  }
+}
+
+DLX::Status DLX::search(uint64_t max_nodes) {
+  const uint64_t node_limit{max_nodes == 0 ? UINT64_MAX
+                                           : node_count + max_nodes};
+  for (;;) {
+    switch (step) {
+    case Step::Enter: {
+      // new search node at the current depth
+      if (node_count == node_limit)
+        return Status::Suspended;
+      ++node_count;
+      if (right(root) == root) {
+        solution.clear();
+        for (int32_t i = 0; i < depth; ++i)
+          solution.push_back(row(stack[i].row));
+        step = Step::Backtrack;
+        return Status::Solved;
+      }
+      const int32_t col{chooseNextColumn()};
+#ifdef DLX_STATISTICS
+      const size_t branches{col == root ? 0u : size_t(columnSize(col))};
+      if (statistics.branching.size() <= branches)
+        statistics.branching.resize(branches + 1);
+      ++statistics.branching[branches];
+#endif
+      if (col == root) {
+        step = Step::Backtrack; // there is a column with no node
+        break;
+      }
+      cover(col);
+      stack[depth++] = Frame{col, down(col), col};
+      DLX_STAT(statistics.max_depth =
+                   std::max(statistics.max_depth, uint32_t(depth)));
+      step = Step::TryRow;
+      break;
+    }
+    case Step::TryRow: {
+      Frame &frame = stack[depth - 1];
+      if (frame.row == frame.end) {
+        // every row of this column has been tried
+        uncover(frame.column);
+        --depth;
+        step = Step::Backtrack;
+        break;
+      }
+      for (int32_t right_node = right(frame.row); right_node != frame.row;
+           right_node = right(right_node))
+        cover(right_node);
+      step = Step::Enter;
+      break;
     }
-    column = column->getRight();
+    case Step::Backtrack: {
+      if (depth == 0) {
+        solution.clear();
+        step = Step::Exhausted;
+        return Status::Unsolvable;
+      }
+      Frame &frame = stack[depth - 1];
+      DLX_STAT(++statistics.backtracks);
+      for (int32_t left_node = left(frame.row); left_node != frame.row;
+           left_node = left(left_node))
+        uncover(left_node);
+      frame.row = down(frame.row);
+      step = Step::TryRow;
+      break;
+    }
+    case Step::Exhausted:
+      return Status::Unsolvable;
+    }
+  }
+}
+
+bool DLX::solve() { return search() == Status::Solved; }
+
+uint64_t DLX::count(uint64_t limit) {
+  uint64_t solutions{0};
+  while (solutions != limit || limit == 0) {
+    if (search() != Status::Solved)
+      break;
+    ++solutions;
   }
-  return next_col;
-}
-
-bool DLX::solve() {
-  if (head->getRight() == head)
-    return true;
-  DLNode *column = chooseNextColumn();
-  if (column == head)
-    return false; // there is a column with no node
-  cover(column);
-  for (auto row = column->getDown(); row != column; row = row->getDown()) {
-    solution.push_back(row->getRow());
-    for (auto rightNode = row->getRight(); rightNode != row;
-         rightNode = rightNode->getRight())
-      cover(rightNode);
-    if (solve())
-      return true;
-    solution.pop_back();
-    for (auto leftNode = row->getLeft(); leftNode != row;
-         leftNode = leftNode->getLeft())
-      uncover(leftNode);
+  return solutions;
+}
+
+uint64_t
+DLX::enumerate(const std::function<bool(const std::vector<int> &)> &sink) {
+  uint64_t solutions{0};
+  while (search() == Status::Solved) {
+    ++solutions;
+    if (!sink(solution))
+      break;
   }
-  uncover(column);
-  return false;
+  return solutions;
 }
 
 std::vector<int> DLX::getSolution() { return solution; }
+
+uint64_t DLX::getNodeCount() { return node_count; }
+
+DLX::Statistics DLX::getStatistics() {
+  statistics.nodes = node_count;
+  return statistics;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * ParallelDLX.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "DLX.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+// search nodes a worker runs between checks for cancellation and idle threads
+const uint64_t slice_nodes{1024};
+} // namespace
+
+struct DLX::ParallelState {
+  // A work item is the list of row nodes to select before searching, which
+  // identifies one subtree of the search.
+  std::mutex mutex{};
+  std::condition_variable work_ready{};
+  std::deque<std::vector<int32_t>> work{};
+  unsigned num_threads{};
+  unsigned waiting{0};
+  std::atomic<unsigned> hungry{0}; // copy of waiting readable without lock
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> nodes{0};
+  std::function<bool(uint64_t)> give_up{};
+  bool solved{false};
+  std::vector<int> solution{};
+  Statistics statistics{}; // sum over all threads
+
+  // blocks until there is work, returns false once the search is over
+  bool take(std::vector<int32_t> &item) {
+    std::unique_lock<std::mutex> lock{mutex};
+    hungry = ++waiting;
+    while (work.empty() && !stop && waiting < num_threads)
+      work_ready.wait(lock);
+    if (stop || work.empty()) {
+      // solved, or every thread is idle with nothing left to search
+      work_ready.notify_all();
+      return false;
+    }
+    item = std::move(work.front());
+    work.pop_front();
+    hungry = --waiting;
+    return true;
+  }
+
+  void found(std::vector<int> rows) {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!stop) {
+      solved = true;
+      solution = std::move(rows);
+      stop = true;
+    }
+    work_ready.notify_all();
+  }
+
+  void abandon() {
+    std::lock_guard<std::mutex> lock{mutex};
+    stop = true;
+    work_ready.notify_all();
+  }
+
+  void merge(const Statistics &worker) {
+    std::lock_guard<std::mutex> lock{mutex};
+    statistics.nodes += worker.nodes;
+    statistics.backtracks += worker.backtracks;
+    statistics.covers += worker.covers;
+    statistics.uncovers += worker.uncovers;
+    statistics.link_updates += worker.link_updates;
+    statistics.max_depth = std::max(statistics.max_depth, worker.max_depth);
+    if (statistics.branching.size() < worker.branching.size())
+      statistics.branching.resize(worker.branching.size());
+    for (size_t i = 0; i < worker.branching.size(); ++i)
+      statistics.branching[i] += worker.branching[i];
+  }
+};
+
+bool DLX::solve(unsigned num_threads) {
+  return solve(num_threads, nullptr) == Status::Solved;
+}
+
+DLX::Status DLX::solve(unsigned num_threads,
+                       const std::function<bool(uint64_t)> &stop) {
+  if (num_threads == 0)
+    num_threads = std::thread::hardware_concurrency();
+  num_threads = std::max(num_threads, 1u);
+  assert(depth == 0 && step == Step::Enter);
+
+  ParallelState state{};
+  state.num_threads = num_threads;
+  state.give_up = stop;
+  state.work.emplace_back(); // the whole search tree
+  auto run = [this, &state]() {
+    DLX worker{*this};
+    worker.work(state);
+  };
+  // the calling thread is one of the workers
+  std::vector<std::thread> threads{};
+  for (unsigned i = 1; i < num_threads; ++i)
+    threads.emplace_back(run);
+  run();
+  for (auto &thread : threads)
+    thread.join();
+
+  solution = state.solution;
+  statistics = state.statistics;
+  node_count = statistics.nodes;
+  step = Step::Exhausted;
+  if (state.solved)
+    return Status::Solved;
+  return state.stop ? Status::Suspended : Status::Unsolvable;
+}
+
+void DLX::work(ParallelState &state) {
+  std::vector<int32_t> prefix{};
+  while (state.take(prefix)) {
+    for (int32_t node : prefix)
+      selectRow(node);
+    step = Step::Enter;
+    Status status{};
+    uint64_t searched{node_count};
+    while ((status = search(slice_nodes)) == Status::Suspended) {
+      const uint64_t nodes{state.nodes += node_count - searched};
+      searched = node_count;
+      if (!state.stop && state.give_up && state.give_up(nodes))
+        state.abandon();
+      if (state.stop)
+        break;
+      if (state.hungry > 0)
+        donate(state, prefix);
+    }
+    state.nodes += node_count - searched;
+    if (status == Status::Suspended)
+      break; // solved elsewhere, or given up
+    if (status == Status::Solved) {
+      std::vector<int> rows{};
+      for (int32_t node : prefix)
+        rows.push_back(row(node));
+      rows.insert(rows.end(), solution.begin(), solution.end());
+      state.found(std::move(rows));
+      break;
+    }
+    for (auto it = prefix.rbegin(); it != prefix.rend(); ++it)
+      unselectRow(*it);
+  }
+  state.merge(getStatistics());
+}
+
+void DLX::donate(ParallelState &state, const std::vector<int32_t> &prefix) {
+  // hand over the untried rows of the shallowest level that has any, they
+  // are the largest subtrees this thread still owns
+  for (int32_t i = 0; i < depth; ++i) {
+    Frame &frame = stack[i];
+    if (down(frame.row) == frame.end)
+      continue;
+    std::vector<int32_t> item{prefix};
+    for (int32_t j = 0; j < i; ++j)
+      item.push_back(stack[j].row);
+    std::lock_guard<std::mutex> lock{state.mutex};
+    for (int32_t r = down(frame.row); r != frame.end; r = down(r)) {
+      item.push_back(r);
+      state.work.push_back(item);
+      item.pop_back();
+    }
+    frame.end = down(frame.row);
+    state.work_ready.notify_all();
+    return;
+  }
+}
@@ -22,28 +22,119 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <time.h>
 #include <vector>
 
+#include "Generator.hpp"
+#include "Parser.hpp"
+#include "PuzzleFile.hpp"
+#include "SolutionCache.hpp"
 #include "Sudoku.hpp"
 #include "SudokuSolver.hpp"
 
+namespace {
+void printStatistics(const DLX::Statistics &stats) {
+  std::cout << "  nodes: " << stats.nodes;
+  if (!DLX::statistics_enabled) {
+    std::cout << " (build with -DDLX_STATISTICS=ON for more)" << std::endl;
+    return;
+  }
+  std::cout << ", backtracks: " << stats.backtracks
+            << ", covers: " << stats.covers
+            << ", uncovers: " << stats.uncovers
+            << ", link updates: " << stats.link_updates
+            << ", max depth: " << stats.max_depth << std::endl
+            << "  branching:";
+  for (size_t i = 0; i < stats.branching.size(); ++i)
+    if (stats.branching[i] > 0)
+      std::cout << " " << i << ":" << stats.branching[i];
+  std::cout << std::endl;
+}
+
+// Reads a whole non-negative number into number, false if value is not one
+// or does not fit.
+template <typename T> bool parseNumber(const std::string &value, T &number) {
+  if (value.empty() || value[0] < '0' || value[0] > '9')
+    return false;
+  unsigned long long parsed{0};
+  size_t used{0};
+  try {
+    parsed = std::stoull(value, &used);
+  } catch (const std::logic_error &) { // invalid_argument or out_of_range
+    return false;
+  }
+  if (used != value.size() ||
+      parsed > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+    return false;
+  number = static_cast<T>(parsed);
+  return true;
+}
+
+// Collects output in memory and writes it to the file in large blocks.
+class BufferedWriter {
+public:
+  explicit BufferedWriter(std::ofstream &file)
+      : file(file), buffer(size_t(1) << 20), used(0) {}
+  ~BufferedWriter() { flush(); }
+
+  // room for n characters, finish with commit() and the end of the text
+  char *reserve(size_t n) {
+    if (buffer.size() - used < n) {
+      flush();
+      if (buffer.size() < n)
+        buffer.resize(n);
+    }
+    return buffer.data() + used;
+  }
+  void commit(char *end) { used = static_cast<size_t>(end - buffer.data()); }
+  void write(const std::string &text) {
+    commit(std::copy(text.begin(), text.end(), reserve(text.size())));
+  }
+  void flush() {
+    if (used > 0 && file.is_open())
+      file.write(buffer.data(), static_cast<std::streamsize>(used));
+    used = 0;
+  }
+
+private:
+  std::ofstream &file;
+  std::vector<char> buffer;
+  size_t used;
+};
+} // namespace
+
 int main(int argc, char *argv[]) {
   bool verbose{false};
   bool write{false};
+  bool stats{false};
+  unsigned threads{1};
+  unsigned portfolio{1};
+  unsigned long timeout_ms{0};
+  unsigned long long max_nodes{0};
+  size_t cache_size{0};
+  unsigned long generate{0};
+  int generate_size{9}, clues{0};
+  uint64_t seed{0};
   std::string input{};
   std::string output{};
+  std::string binary_output{}, text_output{};
 
   // handle arguments
   std::vector<std::string> args(argv, argv + argc);
-  input = args[1];
-  for (size_t i = 2; i < args.size(); ++i) {
+  for (size_t i = 1; i < args.size(); ++i) {
     if (args[i] == "-v")
       verbose = true;
+    else if (args[i] == "--stats")
+      stats = true;
     else if (args[i] == "-o") {
       write = true;
       // if there is no other argument after -o
@@ -52,24 +143,153 @@ int main(int argc, char *argv[]) {
         return 0;
       }
       output = args[++i];
+    } else if (args[i] == "-t" || args[i] == "--threads") {
+      if (i + 1 == args.size() || !parseNumber(args[i + 1], threads)) {
+        std::cout << "Please specify the number of threads." << std::endl;
+        return 0;
+      }
+      ++i;
+    } else if (args[i] == "--portfolio") {
+      if (i + 1 == args.size() || !parseNumber(args[i + 1], portfolio)) {
+        std::cout << "Please specify the number of searches to race."
+                  << std::endl;
+        return 0;
+      }
+      ++i;
+    } else if (args[i] == "--timeout-ms") {
+      if (i + 1 == args.size() || !parseNumber(args[i + 1], timeout_ms)) {
+        std::cout << "Please specify the time limit in milliseconds."
+                  << std::endl;
+        return 0;
+      }
+      ++i;
+    } else if (args[i] == "--max-nodes") {
+      if (i + 1 == args.size() || !parseNumber(args[i + 1], max_nodes)) {
+        std::cout << "Please specify the number of search nodes." << std::endl;
+        return 0;
+      }
+      ++i;
+    } else if (args[i] == "--cache") {
+      if (i + 1 == args.size() || !parseNumber(args[i + 1], cache_size)) {
+        std::cout << "Please specify the number of cached results."
+                  << std::endl;
+        return 0;
+      }
+      ++i;
+    } else if (args[i] == "--to-binary" || args[i] == "--to-text") {
+      if (i + 1 == args.size()) {
+        std::cout << "Please specify the converted file name." << std::endl;
+        return 0;
+      }
+      std::string &converted{args[i] == "--to-binary" ? binary_output
+                                                      : text_output};
+      converted = args[++i];
+    } else if (args[i] == "--generate" || args[i] == "--size" ||
+               args[i] == "--clues" || args[i] == "--seed") {
+      const std::string &flag{args[i]};
+      const std::string value{i + 1 == args.size() ? "" : args[++i]};
+      bool parsed{false};
+      if (flag == "--generate")
+        parsed = parseNumber(value, generate);
+      else if (flag == "--size")
+        parsed = parseNumber(value, generate_size);
+      else if (flag == "--clues")
+        parsed = parseNumber(value, clues);
+      else
+        parsed = parseNumber(value, seed);
+      if (!parsed) {
+        std::cout << "Please specify a number after " << flag << "."
+                  << std::endl;
+        return 0;
+      }
+    } else if (input.empty())
+      input = args[i];
+  }
+
+  // generating instead of solving, one puzzle per line
+  if (generate > 0) {
+    std::ofstream ofile{};
+    if (write)
+      ofile.open(output, std::ofstream::out);
+    BufferedWriter writer{ofile};
+    Generator generator{generate_size, seed};
+    for (unsigned long i = 0; i < generate; ++i) {
+      Sudoku puzzle = generator.puzzle(clues);
+      const int size{puzzle.getSize()};
+      if (size == 0) {
+        std::cout << "Unable to generate " << generate_size << "x"
+                  << generate_size << " puzzles" << std::endl;
+        return 0;
+      }
+      if (!write) {
+        std::cout << puzzle.toSimpleString() << std::endl;
+        continue;
+      }
+      char *out = puzzle.writeSimpleString(writer.reserve(size * size + 1));
+      *out++ = '\n';
+      writer.commit(out);
     }
+    return 0;
   }
   verbose = verbose || !write; // verbose is on by default if no output file
 
   // reading sudoku from file
-  std::ifstream infile(input);
-  if (!infile.good()) {
-    std::cout << "File does not exists! Exiting program" << std::endl;
+  std::vector<Sudoku> puzzles{};
+  if (PuzzleFile::isPuzzleFile(input)) {
+    PuzzleFile file{};
+    if (!file.open(input)) {
+      std::cout << "'" << input << "' is damaged! Exiting program"
+                << std::endl;
+      return 0;
+    }
+    puzzles.reserve(file.getCount());
+    for (uint64_t i = 0; i < file.getCount(); ++i)
+      puzzles.push_back(file.get(i));
+  } else {
+    std::ifstream infile(input, std::ifstream::binary);
+    if (!infile.good()) {
+      std::cout << "File does not exists! Exiting program" << std::endl;
+      return 0;
+    }
+    std::string text{std::istreambuf_iterator<char>(infile),
+                     std::istreambuf_iterator<char>()};
+    infile.close();
+    parsePuzzles(
+        text.data(), text.data() + text.size(),
+        [&](const uint8_t *cells, int size, size_t) {
+          puzzles.emplace_back(cells, size);
+        },
+        [&](const ParseError &error) {
+          std::cout << "Skipping puzzle: " << error.message() << std::endl;
+          // an empty 0 x 0 board keeps the results in line with the input
+          puzzles.emplace_back(std::string{});
+        });
+  }
+
+  // converting instead of solving, without the rejected lines
+  if (!binary_output.empty() || !text_output.empty())
+    puzzles.erase(std::remove_if(puzzles.begin(), puzzles.end(),
+                                 [](Sudoku &sudoku) {
+                                   return sudoku.getSize() == 0;
+                                 }),
+                  puzzles.end());
+  if (!binary_output.empty()) {
+    if (!PuzzleFile::write(binary_output, puzzles))
+      std::cout << "Unable to write '" << binary_output
+                << "', puzzles must all have the same size" << std::endl;
     return 0;
   }
-  std::string line{};
-  std::vector<Sudoku> puzzles{};
-  while (std::getline(infile, line)) {
-    // read file line by line
-    std::istringstream iss(line);
-    puzzles.push_back(Sudoku(line));
+  if (!text_output.empty()) {
+    std::ofstream ofile(text_output, std::ofstream::out);
+    BufferedWriter writer{ofile};
+    for (auto &sudoku : puzzles) {
+      const int size{sudoku.getSize()};
+      char *out = sudoku.writeSimpleString(writer.reserve(size * size + 1));
+      *out++ = '\n';
+      writer.commit(out);
+    }
+    return 0;
   }
-  infile.close();
 
   int index{0};
   unsigned int time{0};
@@ -83,35 +303,93 @@ int main(int argc, char *argv[]) {
       verbose = true;
     }
   }
+  BufferedWriter writer{ofile};
+  std::unique_ptr<SolutionCache> cache{};
+  if (cache_size > 0)
+    cache.reset(new SolutionCache{cache_size});
+  const std::string no_solution{"no solution.\r\n"}, gave_up{"gave up.\r\n"},
+      bad_size{"unsupported size.\r\n"}, bad_puzzle{"bad puzzle.\r\n"};
+  typedef SudokuSolver::SSResult::Status Status;
   // start solving puzzle
   for (auto &sudoku : puzzles) {
+    if (sudoku.getSize() == 0) {
+      std::cout << "Skipping bad puzzle #" << ++index << std::endl;
+      if (write)
+        writer.write(bad_puzzle);
+      continue;
+    }
     std::cout << "Solving " << sudoku.getSize() << "x" << sudoku.getSize()
               << " puzzle #" << ++index << "...     " << std::flush;
     if (verbose)
       std::cout << std::endl << sudoku << std::endl;
     SudokuSolver solver(sudoku);
+    SudokuSolver::SSOptions options{};
+    options.threads = threads;
+    options.portfolio = portfolio;
+    options.max_nodes = max_nodes;
+    options.cache = cache.get();
+    if (timeout_ms > 0)
+      options.deadline = std::chrono::steady_clock::now() +
+                         std::chrono::milliseconds(timeout_ms);
     clock_t start = clock();
-    SudokuSolver::SSResult result = solver.search();
+    SudokuSolver::SSResult result = solver.search(options);
     clock_t end = clock();
     if (result.number_of_solution > 0) {
       std::cout << "Done!!!" << std::endl;
-      Sudoku answer = result.solutions.front();
+      Sudoku &answer = result.solutions.front();
       if (verbose)
         std::cout << "Solution: for puzzle #" << index << std::endl
                   << answer << std::endl;
-    } else
-      std::cout << "No solution found!" << std::endl;
+    } else {
+      // only a complete search shows that there is no solution
+      switch (result.status) {
+      case Status::Complete:
+        std::cout << "No solution found!" << std::endl;
+        break;
+      case Status::OutOfNodes:
+        std::cout << "Gave up after " << max_nodes << " nodes!" << std::endl;
+        break;
+      case Status::OutOfTime:
+        std::cout << "Gave up after " << timeout_ms << "ms!" << std::endl;
+        break;
+      case Status::Cancelled:
+        std::cout << "Cancelled!" << std::endl;
+        break;
+      case Status::BadSize:
+        std::cout << "Unable to solve " << sudoku.getSize() << "x"
+                  << sudoku.getSize() << " puzzles!" << std::endl;
+        break;
+      }
+    }
+    if (stats)
+      printStatistics(result.statistics);
 
     time += static_cast<unsigned int>(end - start);
     if (write) {
-      std::string content = (result.number_of_solution > 0
-                                 ? result.solutions.front().toSimpleString()
-                                 : "no solution.");
-      ofile << content << "\r\n";
+      if (result.number_of_solution > 0) {
+        Sudoku &solution = result.solutions.front();
+        const int size{solution.getSize()};
+        char *out = solution.writeSimpleString(writer.reserve(size * size + 2));
+        *out++ = '\r';
+        *out++ = '\n';
+        writer.commit(out);
+      } else if (result.status == Status::BadSize)
+        writer.write(bad_size);
+      else if (result.status != Status::Complete)
+        writer.write(gave_up);
+      else
+        writer.write(no_solution);
     }
   }
+  writer.flush();
   if (ofile.is_open())
     ofile.close();
+  if (stats && cache) {
+    const SolutionCache::Statistics cached = cache->getStatistics();
+    std::cout << "cache hits: " << cached.hits
+              << ", misses: " << cached.misses
+              << ", evictions: " << cached.evictions << std::endl;
+  }
   std::cout << "it took " << time << "ticks, or "
             << ((float)time) / CLOCKS_PER_SEC << "seconds to solve all "
             << index << " sudoku." << std::endl;
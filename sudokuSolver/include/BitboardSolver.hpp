@@ -0,0 +1,70 @@
+/*
+ * BitboardSolver.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_BITBOARDSOLVER_HPP_
+#define SRC_BITBOARDSOLVER_HPP_
+
+#include "Board.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+
+// Backtracking search for classic 9x9 puzzles, much lighter than the exact
+// cover search for this one size. For every digit a bitboard holds the cells
+// that may still take it, 27 cells to a band of three rows, so the whole
+// state is 120 bytes and a branch simply copies it. Naked and hidden singles
+// and box/line reductions are applied after every placement, and the search
+// branches on a cell with the fewest candidates.
+class BitboardSolver {
+public:
+  enum class Status {
+    Complete,   // searched everything, or sink asked to stop
+    OutOfNodes, // reached max_nodes
+    Stopped     // stop returned true
+  };
+
+  explicit BitboardSolver(const Board<9> &puzzle);
+
+  // Passes every solution to sink until it returns false. A node is a try
+  // of one candidate in a branch, at most max_nodes are tried (0 means no
+  // limit) and stop is asked every poll_nodes nodes whether to give up.
+  Status search(const std::function<bool(const Board<9> &)> &sink,
+                uint64_t max_nodes = 0,
+                const std::function<bool(uint64_t)> &stop = nullptr,
+                uint64_t poll_nodes = 4096);
+  uint64_t getNodeCount() const { return nodes; }
+
+private:
+  struct State {
+    // digit d may go into cell 27 * b + i if bit i of digits[3 * d + b] is
+    // set, a filled cell keeps only the bit of its digit
+    std::array<uint32_t, 27> digits;
+    std::array<uint32_t, 3> unsolved; // empty cells of each band
+    uint32_t dirty; // digits changed since their hidden singles were checked
+  };
+
+  // puts digit d (0 based) into an empty cell that can take it
+  static void place(State &state, int cell, int d);
+  // fills in singles until there are none, false on a contradiction
+  static bool propagate(State &state);
+  // applies the box/line reductions of digit d (0 based) and fills in its
+  // hidden singles, false if some unit has no place left for it
+  static bool hiddenSingles(State &state, int d);
+  // false if the search has to stop
+  bool branch(State &state);
+
+  State start;
+  bool broken; // the givens clash
+  const std::function<bool(const Board<9> &)> *sink;
+  const std::function<bool(uint64_t)> *stop;
+  uint64_t max_nodes;
+  uint64_t poll_nodes;
+  uint64_t nodes;
+  Status status;
+};
+
+#endif /* SRC_BITBOARDSOLVER_HPP_ */
@@ -0,0 +1,143 @@
+/*
+ * Board.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_BOARD_HPP_
+#define SRC_BOARD_HPP_
+
+#include "Sudoku.hpp"
+#include <array>
+#include <cstdint>
+
+namespace board_detail {
+// smallest root with root * root >= n
+constexpr int boxWidth(int n, int root = 1) {
+  return root * root >= n ? root : boxWidth(n, root + 1);
+}
+} // namespace board_detail
+
+// Sudoku of a size fixed at compile time, the box geometry and every loop
+// bound are constants. Cells hold 0 when empty.
+template <int N> class Board {
+public:
+  static constexpr int size = N;
+  static constexpr int box = board_detail::boxWidth(N);
+  static constexpr int num_cells = N * N;
+  static_assert(box * box == N, "Board size must be a perfect square");
+  static_assert(N <= 255, "cells are stored in one byte");
+
+  Board() : cells{} {}
+  // sudoku must be N x N
+  explicit Board(Sudoku &sudoku);
+
+  int getCell(int row, int col) const { return cells[row * N + col]; }
+  void setCell(int row, int col, int num) {
+    cells[row * N + col] = static_cast<uint8_t>(num);
+  }
+  bool cellIsEmpty(int row, int col) const { return getCell(row, col) == 0; }
+  // box index of a cell, boxes are numbered row by row
+  static int boxOf(int row, int col) { return row / box * box + col / box; }
+
+  // num may go into the empty cell at (row, col)
+  bool isSafe(int row, int col, int num) const;
+  bool isComplete() const;
+  // complete, and every row, column and box holds each digit once
+  bool isCorrect() const;
+  Sudoku toSudoku() const;
+
+  bool operator==(const Board &rhs) const { return cells == rhs.cells; }
+
+private:
+  // bit num - 1 for a digit, nothing for an empty or invalid cell
+  static uint32_t digitBit(int num) {
+    return num >= 1 && num <= N ? uint32_t(1) << (num - 1) : 0;
+  }
+
+  std::array<uint8_t, N * N> cells;
+};
+
+template <int N> constexpr int Board<N>::size;
+template <int N> constexpr int Board<N>::box;
+template <int N> constexpr int Board<N>::num_cells;
+
+template <int N> Board<N>::Board(Sudoku &sudoku) {
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      setCell(i, j, sudoku.getCell(i, j));
+}
+
+template <int N> bool Board<N>::isSafe(int row, int col, int num) const {
+  if (!cellIsEmpty(row, col))
+    return false;
+  const int box_row{row - row % box}, box_col{col - col % box};
+  for (int i = 0; i < N; ++i) {
+    if (getCell(row, i) == num || getCell(i, col) == num ||
+        getCell(box_row + i / box, box_col + i % box) == num)
+      return false;
+  }
+  return true;
+}
+
+template <int N> bool Board<N>::isComplete() const {
+  for (uint8_t num : cells)
+    if (num == 0)
+      return false;
+  return true;
+}
+
+template <int N> bool Board<N>::isCorrect() const {
+  // a unit is correct when the bits of its digits cover every digit
+  const uint32_t all{(uint32_t(1) << N) - 1};
+  for (int unit = 0; unit < N; ++unit) {
+    uint32_t in_row{0}, in_col{0}, in_box{0};
+    const int box_row{unit / box * box}, box_col{unit % box * box};
+    for (int i = 0; i < N; ++i) {
+      in_row |= digitBit(getCell(unit, i));
+      in_col |= digitBit(getCell(i, unit));
+      in_box |= digitBit(getCell(box_row + i / box, box_col + i % box));
+    }
+    if (in_row != all || in_col != all || in_box != all)
+      return false;
+  }
+  return true;
+}
+
+template <int N> Sudoku Board<N>::toSudoku() const {
+  return Sudoku{cells.data(), N};
+}
+
+// Calls visitor.template visit<N>() for the Board size N equal to size, the
+// one place a run time size turns into a compile time one. Sizes without a
+// Board instantiation return fallback.
+template <typename R, typename Visitor>
+R dispatchBoardSize(int size, Visitor &visitor, R fallback) {
+  switch (size) {
+  case 4:
+    return visitor.template visit<4>();
+  case 9:
+    return visitor.template visit<9>();
+  case 16:
+    return visitor.template visit<16>();
+  case 25:
+    return visitor.template visit<25>();
+  default:
+    return fallback;
+  }
+}
+
+namespace board_detail {
+struct HasBoard {
+  template <int N> bool visit() { return true; }
+};
+} // namespace board_detail
+
+// whether dispatchBoardSize() has a Board for size
+inline bool hasBoardSize(int size) {
+  board_detail::HasBoard has_board{};
+  return dispatchBoardSize(size, has_board, false);
+}
+
+#endif /* SRC_BOARD_HPP_ */
@@ -0,0 +1,46 @@
+/*
+ * Canonical.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_CANONICAL_HPP_
+#define SRC_CANONICAL_HPP_
+
+#include "Sudoku.hpp"
+#include <array>
+#include <cstdint>
+
+// largest size canonicalize() handles, bigger ones have too many symmetries
+const int max_canonical_size{9};
+// largest size a Transform handles
+const int max_transform_size{25};
+
+// A change of a puzzle that keeps it a puzzle: an optional transposition,
+// then a reordering of the rows and columns that keeps bands and stacks
+// together, then a relabelling of the digits. Row i of the result is row
+// rows[i] of the (transposed) puzzle, column j is column cols[j], and digit
+// num becomes digits[num]. Empty cells stay empty.
+struct Transform {
+  int size{0};
+  bool transposed{false};
+  std::array<uint8_t, max_transform_size> rows{};
+  std::array<uint8_t, max_transform_size> cols{};
+  std::array<uint8_t, max_transform_size + 1> digits{};
+
+  // the identity of the given size
+  static Transform identity(int size);
+  // puzzle must be size x size
+  Sudoku apply(Sudoku &puzzle) const;
+  // undoes apply(), e.g. to map the solution of a canonical puzzle back
+  Sudoku revert(Sudoku &sudoku) const;
+};
+
+// Sets canonical to the smallest puzzle, comparing cells row by row, that a
+// transform can turn puzzle into, and transform to one that does. Puzzles
+// that are transforms of each other have the same canonical form. Returns
+// false, and leaves both alone, for sizes other than 4 and 9.
+bool canonicalize(Sudoku &puzzle, Sudoku &canonical, Transform &transform);
+
+#endif /* SRC_CANONICAL_HPP_ */
@@ -0,0 +1,77 @@
+/*
+ * Generator.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_GENERATOR_HPP_
+#define SRC_GENERATOR_HPP_
+
+#include "DLX.hpp"
+#include "Sudoku.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Makes random puzzles with exactly one solution. A random complete grid is
+// dug out one clue at a time, in random order, keeping a clue only if the
+// solution is no longer unique without it. One exact cover matrix serves
+// every check: the clues are selected and taken back as the digging goes,
+// and the matrix is never built again. The same seed gives the same puzzles.
+class Generator {
+public:
+  // sizes other than 4, 9, 16 and 25 only give empty 0 x 0 sudokus
+  explicit Generator(int size = 9, uint64_t seed = 0);
+
+  // a random complete grid
+  Sudoku grid();
+  // digs a new grid, see dig()
+  Sudoku puzzle(int target_clues = 0);
+  // Takes clues out of solution until target_clues are left or none can go
+  // without a second solution appearing, so with a target of 0 the puzzle
+  // is minimal. solution must be a correct complete grid of this size.
+  Sudoku dig(Sudoku &solution, int target_clues = 0);
+
+private:
+  // row of the clue of a cell
+  int rowOf(int cell) const { return cell * size + answer[cell] - 1; }
+  // i-th cell of a row (unit < size), column or box
+  int unitCell(int unit, int i) const {
+    const int index{unit % size};
+    switch (unit / size) {
+    case 0:
+      return index * size + i;
+    case 1:
+      return i * size + index;
+    default:
+      return (index / box * box + i / box) * size + index % box * box +
+             i % box;
+    }
+  }
+  // the other clues force the digit of the cell as a naked or hidden single,
+  // a cheap way to tell that the clue can go
+  bool isForced(int cell);
+  // some solution without the clue of the cell has another digit there
+  bool hasOtherSolution(int cell);
+  // Decides the cells order[first..last). On entry the clues left outside
+  // the range are selected and those in it are not, on return the clues
+  // kept in the range are selected on top.
+  void decide(int first, int last);
+  void shuffle(std::vector<int> &items);
+
+  int size;
+  int box;
+  std::mt19937_64 rng;
+  std::unique_ptr<DLX> dlx{};
+  std::vector<uint8_t> answer{}; // solution being dug
+  std::vector<int> order{};      // cells in the order they are tried
+  std::vector<bool> kept{};      // clues still in the puzzle
+  // digits of the clues still in each row, column and box
+  std::vector<uint32_t> unit_digits{};
+  int clues{0};
+  int target{0};
+};
+
+#endif /* SRC_GENERATOR_HPP_ */
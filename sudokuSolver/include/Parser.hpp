@@ -0,0 +1,52 @@
+/*
+ * Parser.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_PARSER_HPP_
+#define SRC_PARSER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Puzzles are written one per line, row by row, with '.' or '0' for empty
+// cells, '1'-'9' for digits up to 9 and 'A'-'P' or 'a'-'p' for 10 to 25.
+// Trailing spaces, tabs and '\r' are ignored.
+
+// cells in the largest puzzle, 25 x 25
+const int max_puzzle_cells{625};
+
+// where and why a line was rejected
+struct ParseError {
+  enum class Reason {
+    None,
+    BadLength,      // not 16, 81, 256 or 625 cells
+    BadCharacter,   // not a digit, letter or empty cell
+    DigitOutOfRange // larger than the size of the puzzle
+  };
+  Reason reason = Reason::None;
+  size_t line = 0;   // counted from 1, 0 for a single puzzle
+  size_t column = 0; // counted from 1, 0 for a bad length
+
+  bool failed() const { return reason != Reason::None; }
+  std::string message() const;
+};
+
+// Parses one puzzle into cells, which must hold max_puzzle_cells values,
+// and sets size on success. Nothing is allocated.
+ParseError parsePuzzle(const char *begin, const char *end, uint8_t *cells,
+                       int *size);
+
+// Parses every line of [begin, end), passing the cells of good lines to
+// on_puzzle along with their size and line number, and the errors of bad
+// ones to on_error. Blank lines are skipped.
+void parsePuzzles(
+    const char *begin, const char *end,
+    const std::function<void(const uint8_t *, int, size_t)> &on_puzzle,
+    const std::function<void(const ParseError &)> &on_error);
+
+#endif /* SRC_PARSER_HPP_ */
@@ -0,0 +1,290 @@
+/*
+ * Propagator.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_PROPAGATOR_HPP_
+#define SRC_PROPAGATOR_HPP_
+
+#include "Board.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Fills in what a puzzle forces before any search: naked singles, hidden
+// singles, and box/line reductions, which take a digit confined to one line
+// of a box out of the rest of that line, and the other way round. The
+// candidates of every cell are a mask, bit num - 1 for num.
+template <int N> class Propagator {
+public:
+  enum class Outcome {
+    Solved,       // every cell is forced, so there is exactly one solution
+    Stuck,        // cells are left that need a search
+    Contradiction // the puzzle has no solution
+  };
+  // extra regions in which no digit repeats, as lists of (row, col) cells,
+  // those of N cells hold every digit
+  typedef std::vector<std::vector<std::pair<int, int>>> Regions;
+
+  explicit Propagator(const Board<N> &puzzle,
+                      const Regions &extra_regions = {});
+
+  Outcome run();
+  // the puzzle with every forced cell filled in
+  const Board<N> &getBoard() const { return board; }
+  // digits still possible in an empty cell, 0 for a filled one
+  uint32_t candidates(int row, int col) const { return cands[row * N + col]; }
+
+private:
+  static const uint32_t all = uint32_t((uint64_t(1) << N) - 1);
+  static constexpr int box = Board<N>::box;
+
+  // puts num into an empty cell and takes it out of every peer, false if
+  // the cell cannot hold it or num is not a digit
+  bool place(int cell, int num);
+  // The rules return false on a contradiction, including an empty cell left
+  // without candidates, which any placement may cause.
+  bool nakedSingles(bool &progress);
+  bool hiddenSingles(const int *unit, bool &progress);
+  void boxLine(bool &progress);
+
+  Board<N> board;
+  std::array<uint32_t, N * N> cands;
+  std::vector<std::vector<int>> regions{}; // cells of each extra region
+  std::vector<bool> full{};                // region holds every digit
+  std::vector<std::vector<int>> regions_of{}; // regions of each cell
+  bool broken{false};                         // two givens clash
+};
+
+template <int N> const uint32_t Propagator<N>::all;
+template <int N> constexpr int Propagator<N>::box;
+
+namespace propagator_detail {
+inline int lowestDigit(uint32_t bits) {
+  int num{1};
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++num;
+  }
+  return num;
+}
+
+// cells of every row, column and box, in that order
+template <int N> struct Units {
+  static const Units &get() {
+    static const Units units{};
+    return units;
+  }
+  std::array<std::array<int, N>, 3 * N> cells;
+
+private:
+  Units() {
+    const int box{Board<N>::box};
+    for (int u = 0; u < N; ++u) {
+      for (int i = 0; i < N; ++i) {
+        cells[u][i] = u * N + i;
+        cells[N + u][i] = i * N + u;
+        cells[2 * N + u][i] =
+            (u / box * box + i / box) * N + u % box * box + i % box;
+      }
+    }
+  }
+};
+} // namespace propagator_detail
+
+template <int N>
+Propagator<N>::Propagator(const Board<N> &puzzle,
+                          const Regions &extra_regions)
+    : board(), cands() {
+  cands.fill(all);
+  if (!extra_regions.empty()) {
+    regions_of.resize(N * N);
+    for (auto &region : extra_regions) {
+      regions.emplace_back();
+      for (auto &cell : region) {
+        regions.back().push_back(cell.first * N + cell.second);
+        regions_of[cell.first * N + cell.second].push_back(
+            static_cast<int>(regions.size()) - 1);
+      }
+      full.push_back(static_cast<int>(region.size()) == N);
+    }
+  }
+  for (int cell = 0; cell < N * N; ++cell) {
+    const int num{puzzle.getCell(cell / N, cell % N)};
+    if (num != 0 && !place(cell, num))
+      broken = true;
+  }
+}
+
+template <int N> bool Propagator<N>::place(int cell, int num) {
+  if (num < 1 || num > N)
+    return false;
+  const uint32_t bit{uint32_t(1) << (num - 1)};
+  if ((cands[cell] & bit) == 0)
+    return false;
+  board.setCell(cell / N, cell % N, num);
+  const int row{cell / N}, col{cell % N};
+  const propagator_detail::Units<N> &units = propagator_detail::Units<N>::get();
+  const int *box_cells{units.cells[2 * N + Board<N>::boxOf(row, col)].data()};
+  // peers left without candidates are caught by nakedSingles()
+  const uint32_t keep{~bit};
+  for (int i = 0; i < N; ++i) {
+    cands[row * N + i] &= keep;
+    cands[i * N + col] &= keep;
+    cands[box_cells[i]] &= keep;
+  }
+  if (!regions_of.empty())
+    for (int region : regions_of[cell])
+      for (int peer : regions[region])
+        cands[peer] &= keep;
+  cands[cell] = 0;
+  return true;
+}
+
+template <int N> bool Propagator<N>::nakedSingles(bool &progress) {
+  for (int cell = 0; cell < N * N; ++cell) {
+    const uint32_t bits{cands[cell]};
+    if (bits == 0) {
+      if (board.cellIsEmpty(cell / N, cell % N))
+        return false; // no digit fits
+      continue;
+    }
+    if ((bits & (bits - 1)) != 0)
+      continue;
+    place(cell, propagator_detail::lowestDigit(bits));
+    progress = true;
+  }
+  return true;
+}
+
+template <int N>
+bool Propagator<N>::hiddenSingles(const int *unit, bool &progress) {
+  // digits seen once, more than once, and already placed in the unit
+  uint32_t once{0}, twice{0}, placed{0};
+  for (int i = 0; i < N; ++i) {
+    const uint32_t bits{cands[unit[i]]};
+    twice |= once & bits;
+    once |= bits;
+    if (bits == 0) {
+      // an earlier single in this sweep may have taken the last candidate
+      const int num{board.getCell(unit[i] / N, unit[i] % N)};
+      if (num == 0)
+        return false;
+      placed |= uint32_t(1) << (num - 1);
+    }
+  }
+  if ((once | placed) != all)
+    return false; // a digit has nowhere to go
+  for (uint32_t single = once & ~twice & ~placed; single != 0;
+       single &= single - 1) {
+    const uint32_t bit{single & (~single + 1)};
+    for (int i = 0; i < N; ++i) {
+      if ((cands[unit[i]] & bit) == 0)
+        continue;
+      if (!place(unit[i], propagator_detail::lowestDigit(bit)))
+        return false;
+      progress = true;
+      break;
+    }
+  }
+  return true;
+}
+
+template <int N> void Propagator<N>::boxLine(bool &progress) {
+  const propagator_detail::Units<N> &units = propagator_detail::Units<N>::get();
+  // cells left without candidates are caught by nakedSingles()
+  auto take = [&](int cell, uint32_t bits) {
+    if ((cands[cell] & bits) != 0) {
+      progress = true;
+      cands[cell] &= ~bits;
+    }
+  };
+  for (int b = 0; b < N; ++b) {
+    const int *cells{units.cells[2 * N + b].data()};
+    // candidates of each row and each column of the box
+    uint32_t rows[box] = {}, cols[box] = {};
+    for (int i = 0; i < N; ++i) {
+      rows[i / box] |= cands[cells[i]];
+      cols[i % box] |= cands[cells[i]];
+    }
+    const int first_row{b / box * box}, first_col{b % box * box};
+    for (int k = 0; k < box; ++k) {
+      uint32_t other_rows{0}, other_cols{0};
+      for (int j = 0; j < box; ++j) {
+        if (j != k) {
+          other_rows |= rows[j];
+          other_cols |= cols[j];
+        }
+      }
+      // pointing: digits of the box only in this line leave the rest of it
+      const uint32_t row_only{rows[k] & ~other_rows};
+      const uint32_t col_only{cols[k] & ~other_cols};
+      for (int i = 0; i < N; ++i) {
+        if (row_only != 0 && (i < first_col || i >= first_col + box))
+          take((first_row + k) * N + i, row_only);
+        if (col_only != 0 && (i < first_row || i >= first_row + box))
+          take(i * N + first_col + k, col_only);
+      }
+    }
+  }
+  // claiming: digits of a line only in one box leave the rest of that box
+  for (int line = 0; line < N; ++line) {
+    uint32_t row_parts[box] = {}, col_parts[box] = {};
+    for (int i = 0; i < N; ++i) {
+      row_parts[i / box] |= cands[line * N + i];
+      col_parts[i / box] |= cands[i * N + line];
+    }
+    for (int k = 0; k < box; ++k) {
+      uint32_t other_rows{0}, other_cols{0};
+      for (int j = 0; j < box; ++j) {
+        if (j != k) {
+          other_rows |= row_parts[j];
+          other_cols |= col_parts[j];
+        }
+      }
+      const uint32_t row_only{row_parts[k] & ~other_rows};
+      const uint32_t col_only{col_parts[k] & ~other_cols};
+      for (int i = 0; i < N; ++i) {
+        // the box of row line and columns k * box.., and the other way round
+        const int r{line / box * box + i / box}, c{k * box + i % box};
+        if (row_only != 0 && r != line)
+          take(r * N + c, row_only);
+        const int r2{k * box + i % box}, c2{line / box * box + i / box};
+        if (col_only != 0 && c2 != line)
+          take(r2 * N + c2, col_only);
+      }
+    }
+  }
+}
+
+template <int N>
+typename Propagator<N>::Outcome Propagator<N>::run() {
+  if (broken)
+    return Outcome::Contradiction;
+  const propagator_detail::Units<N> &units = propagator_detail::Units<N>::get();
+  // cheaper rules first, the next one only runs when they are stuck
+  for (;;) {
+    bool progress{false};
+    if (!nakedSingles(progress))
+      return Outcome::Contradiction;
+    if (progress)
+      continue;
+    for (auto &unit : units.cells)
+      if (!hiddenSingles(unit.data(), progress))
+        return Outcome::Contradiction;
+    for (size_t r = 0; r < regions.size(); ++r)
+      if (full[r] && !hiddenSingles(regions[r].data(), progress))
+        return Outcome::Contradiction;
+    if (progress)
+      continue;
+    boxLine(progress);
+    if (!progress)
+      break;
+  }
+  return board.isComplete() ? Outcome::Solved : Outcome::Stuck;
+}
+
+#endif /* SRC_PROPAGATOR_HPP_ */
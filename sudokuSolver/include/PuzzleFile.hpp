@@ -0,0 +1,66 @@
+/*
+ * PuzzleFile.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_PUZZLEFILE_HPP_
+#define SRC_PUZZLEFILE_HPP_
+
+#include "Sudoku.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary file of puzzles (or solutions) of one size. All numbers are little
+// endian.
+//   header   "SDKP", uint16 version, uint8 size, uint8 bits per cell,
+//            uint64 number of puzzles
+//   index    uint64 file offset of every puzzle
+//   puzzles  cells row by row, bits per cell each, lowest bits first
+// Cells take 4 bits up to 9 x 9 and 5 bits for 16 x 16 and 25 x 25, so a
+// 9 x 9 puzzle is 41 bytes.
+class PuzzleFile {
+public:
+  static const uint16_t version = 1;
+  static const size_t header_bytes = 16;
+
+  PuzzleFile() = default;
+  PuzzleFile(const PuzzleFile &) = delete;
+  PuzzleFile &operator=(const PuzzleFile &) = delete;
+  ~PuzzleFile();
+
+  // Maps the file into memory, or reads it where mmap is not available.
+  // Returns false if it cannot be read or is not a valid puzzle file.
+  bool open(const std::string &path);
+  void close();
+
+  int getSize() const { return size; }
+  uint64_t getCount() const { return count; }
+  // unpacks puzzle i into size * size cells
+  void read(uint64_t i, uint8_t *cells) const;
+  Sudoku get(uint64_t i) const;
+
+  // true if the file starts like a puzzle file
+  static bool isPuzzleFile(const std::string &path);
+  // Writes puzzles, which must all have the same size, to path. Returns
+  // false if the sizes differ or the file cannot be written.
+  static bool write(const std::string &path, std::vector<Sudoku> &puzzles);
+  // bytes of one packed puzzle
+  static size_t recordBytes(int size);
+
+private:
+  bool load(const std::string &path);
+  bool checkContents();
+
+  const uint8_t *data{nullptr};
+  size_t length{0};
+  bool mapped{false};
+  std::vector<uint8_t> contents{}; // the file, when it was not mapped
+  int size{0};
+  uint64_t count{0};
+};
+
+#endif /* SRC_PUZZLEFILE_HPP_ */
@@ -0,0 +1,90 @@
+/*
+ * SolutionCache.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_SOLUTIONCACHE_HPP_
+#define SRC_SOLUTIONCACHE_HPP_
+
+#include "SudokuSolver.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Bounded cache of search results, set in SudokuSolver::SSOptions::cache.
+// Results are keyed by a 128 bit hash of the puzzle and of everything else
+// that decides them, and are spread over shards with a lock and a least
+// recently used order each, so threads rarely wait for each other. Safe to
+// share between threads.
+class SolutionCache {
+public:
+  struct Key {
+    uint64_t low;
+    uint64_t high;
+    bool operator==(const Key &other) const {
+      return low == other.low && high == other.high;
+    }
+  };
+
+  // 128 bit hash of a sequence of numbers, in two independent halves
+  class Hasher {
+  public:
+    void add(uint64_t value);
+    Key key() const;
+
+  private:
+    uint64_t low{0xcbf29ce484222325ULL};
+    uint64_t high{0x9e3779b97f4a7c15ULL};
+    uint64_t count{0};
+  };
+
+  struct Statistics {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0; // results held
+  };
+
+  // holds up to capacity results, at least one per shard
+  explicit SolutionCache(size_t capacity, unsigned num_shards = 16);
+
+  // copies the result stored for key, if any, to result
+  bool find(const Key &key, SudokuSolver::SSResult &result);
+  // stores result, evicting the least recently used one of its shard if full
+  void insert(const Key &key, const SudokuSolver::SSResult &result);
+  void clear();
+  Statistics getStatistics();
+
+private:
+  struct Entry {
+    Key key;
+    SudokuSolver::SSResult result;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      return static_cast<size_t>(key.low);
+    }
+  };
+  struct Shard {
+    std::mutex mutex;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  };
+
+  Shard &shardOf(const Key &key) { return *shards[key.high % shards.size()]; }
+
+  std::vector<std::unique_ptr<Shard>> shards;
+  size_t shard_capacity;
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> evictions{0};
+};
+
+#endif /* SRC_SOLUTIONCACHE_HPP_ */
@@ -0,0 +1,133 @@
+/*
+ * Solver.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_SOLVER_HPP_
+#define SRC_SOLVER_HPP_
+
+#include "Board.hpp"
+#include "DLX.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Exact cover formulation of a classic N x N sudoku. Row (row * N + col) * N
+// + num - 1 places num at (row, col), and the columns are the cell, row,
+// column and box constraints, N * N of each. SudokuSolver appends the
+// columns of variant regions to these.
+template <int N> class Solver {
+public:
+  static constexpr int num_rows = N * N * N;
+  static constexpr int num_columns = 4 * N * N;
+
+  explicit Solver(const Board<N> &puzzle) : puzzle(puzzle), solution() {}
+
+  // finds the first solution, false if there is none
+  bool solve();
+  const Board<N> &getSolution() const { return solution; }
+
+  static int rowId(int row, int col, int num) {
+    return (row * N + col) * N + (num - 1);
+  }
+  // columns of the four constraints satisfied by placing num at (row, col),
+  // in ascending order
+  static std::array<int, 4> columns(int row, int col, int num) {
+    return {{row * N + col, N * N + row * N + (num - 1),
+             2 * N * N + col * N + (num - 1),
+             3 * N * N + Board<N>::boxOf(row, col) * N + (num - 1)}};
+  }
+  // every candidate of every cell, in row id order
+  static std::vector<std::vector<int>> exactCover();
+  // only the givens and the candidates of the empty cells that agree with
+  // them, rows of the other candidates are left empty to keep the row ids.
+  // A given over N gets no row, so selectGivens() rejects it.
+  static std::vector<std::vector<int>> exactCover(const Board<N> &puzzle);
+  // selects the rows of the givens, false if they break the rules
+  static bool selectGivens(DLX &dlx, const Board<N> &puzzle);
+  // fills in the cells placed by solution rows
+  static void apply(const std::vector<int> &rows, Board<N> &board);
+
+private:
+  Board<N> puzzle;
+  Board<N> solution;
+};
+
+template <int N> constexpr int Solver<N>::num_rows;
+template <int N> constexpr int Solver<N>::num_columns;
+
+template <int N> bool Solver<N>::solve() {
+  DLX dlx{num_columns, exactCover(puzzle)};
+  if (!selectGivens(dlx, puzzle) || !dlx.solve())
+    return false;
+  solution = puzzle;
+  apply(dlx.getSolution(), solution);
+  return true;
+}
+
+template <int N> std::vector<std::vector<int>> Solver<N>::exactCover() {
+  std::vector<std::vector<int>> matrix{};
+  matrix.reserve(num_rows);
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      for (int num = 1; num <= N; ++num) {
+        const std::array<int, 4> row = columns(i, j, num);
+        matrix.emplace_back(row.begin(), row.end());
+      }
+  return matrix;
+}
+
+template <int N>
+std::vector<std::vector<int>> Solver<N>::exactCover(const Board<N> &puzzle) {
+  // digits given in each row, column and box
+  std::array<uint32_t, N> rows{}, cols{}, boxes{};
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      const int num{puzzle.getCell(i, j)};
+      if (num == 0 || num > N)
+        continue;
+      const uint32_t bit{uint32_t(1) << (num - 1)};
+      rows[i] |= bit;
+      cols[j] |= bit;
+      boxes[Board<N>::boxOf(i, j)] |= bit;
+    }
+  }
+  std::vector<std::vector<int>> matrix(num_rows);
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      const int given{puzzle.getCell(i, j)};
+      const uint32_t taken{rows[i] | cols[j] | boxes[Board<N>::boxOf(i, j)]};
+      for (int num = 1; num <= N; ++num) {
+        if (given != 0 ? num != given : (taken >> (num - 1) & 1) != 0)
+          continue;
+        const std::array<int, 4> row = columns(i, j, num);
+        matrix[rowId(i, j, num)].assign(row.begin(), row.end());
+      }
+    }
+  }
+  return matrix;
+}
+
+template <int N>
+bool Solver<N>::selectGivens(DLX &dlx, const Board<N> &puzzle) {
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      const int num{puzzle.getCell(i, j)};
+      if (num == 0)
+        continue;
+      if (num > N || !dlx.select(rowId(i, j, num)))
+        return false;
+    }
+  }
+  return true;
+}
+
+template <int N>
+void Solver<N>::apply(const std::vector<int> &rows, Board<N> &board) {
+  for (int id : rows)
+    board.setCell(id / (N * N), id / N % N, id % N + 1);
+}
+
+#endif /* SRC_SOLVER_HPP_ */
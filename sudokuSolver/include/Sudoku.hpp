@@ -8,51 +8,72 @@
 #ifndef SRC_SUDOKU_HPP_
 #define SRC_SUDOKU_HPP_
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
 class Sudoku {
 private:
-  int **cells{NULL};
-  int size;
+  // One allocation holds the digit masks of the rows, the columns and the
+  // boxes, in that order, followed by the cells, row-major and one byte
+  // each. Bit num - 1 of a mask is set when num is in that unit.
+  uint32_t *masks{nullptr};
+  uint8_t *cells{nullptr};
+  int size{0};
+  int box_size{0};    // width of a box
+  int num_boxes{0};   // boxes along a row or column of boxes
+  int num_empty{0};   // cells holding 0
+  int num_repeats{0}; // digits placed in a unit that already had them
 
 public:
   Sudoku(int **const arr, int size);
-  Sudoku(std::string input);
+  // size * size values, row by row
+  Sudoku(const uint8_t *values, int size);
+  // see Parser.hpp for the format, bad input gives a 0 x 0 board
+  Sudoku(const std::string &input);
   Sudoku(const Sudoku &other);
+  Sudoku(Sudoku &&other) noexcept;
   ~Sudoku();
 
   std::string toString();
   std::string toSimpleString();
+  // Write the same text as above to out without allocating, and return the
+  // end of it. out needs room for maxStringLength(size) characters, or
+  // size * size for the simple string.
+  static size_t maxStringLength(int size);
+  char *writeString(char *out);
+  char *writeSimpleString(char *out);
   bool isSafe(int row, int col, int num);
   bool isIncomplete();
   bool isComplete();
   bool isCorrect();
   bool cellIsEmpty(int row, int col);
+  // mask of the digits that may go into an empty cell, 0 if it is filled
+  uint32_t candidates(int row, int col);
 
   int getSize();
   void setCell(int row, int col, int val);
   int getCell(int row, int col);
   Sudoku &operator=(const Sudoku &rhs);
+  Sudoku &operator=(Sudoku &&rhs) noexcept;
   bool operator==(Sudoku &rhs);
   friend std::ostream &operator<<(std::ostream &os, Sudoku &sudoku);
 
 private:
-  bool safeInRow(int row, int num);
-  bool safeInCol(int col, int num);
-  bool safeInSqr(int startRow, int startCol, int num);
-  bool correctInRow(int row);
-  bool correctInCol(int col);
-  bool correctInSqr(int startRow, int StartCol);
+  uint32_t digitBit(int num);
+  uint32_t &rowMask(int row) { return masks[row]; }
+  uint32_t &colMask(int col) { return masks[size + col]; }
+  uint32_t &boxMask(int row, int col) {
+    return masks[2 * size + row / box_size * num_boxes + col / box_size];
+  }
+  void addDigit(int row, int col, int num);
+  void removeDigit(int row, int col, int num);
 
   void initCells();
-  int parseChar(char c);
-  void fillSudoku(std::string &input);
-  std::string sudokuToString();
-  std::string otherToString();
-
-  void rtrim(std::string &s, char c);
+  size_t blockWords() const;
+  char *writeBoxString(char *out);
+  char *writeOtherString(char *out);
 };
 
 #endif /* SRC_SUDOKU_HPP_ */
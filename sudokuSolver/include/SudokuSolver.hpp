@@ -8,32 +8,112 @@
 #ifndef SRC_SUDOKUSOLVER_HPP_
 #define SRC_SUDOKUSOLVER_HPP_
 
+#include "DLX.hpp"
 #include "Sudoku.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+class SolutionCache;
 
 class SudokuSolver {
 public:
   struct SSResult {
     // sudoku solver result
+    enum class Status {
+      Complete,   // searched as far as the options asked
+      OutOfNodes, // stopped at SSOptions::max_nodes
+      OutOfTime,  // stopped at SSOptions::deadline
+      Cancelled,  // stopped by SSOptions::cancel
+      BadSize     // the size is not a square, so the grid has no boxes
+    };
+    Status status = Status::Complete;
     unsigned number_of_solution = 0;
     std::vector<Sudoku> solutions;
+    DLX::Statistics statistics;
+  };
+
+  struct SSOptions {
+    // sudoku solver options
+    // stop after this many solutions, 0 to search for every solution
+    unsigned max_solutions = 1;
+    // number of solutions kept in SSResult::solutions
+    unsigned max_stored = 1;
+    // called with every solution found, return false to stop the search
+    std::function<bool(const Sudoku &)> on_solution;
+    // threads used to look for a single solution, 0 means one per core
+    unsigned threads = 1;
+    // Limits on the search, checked every few thousand nodes. A search that
+    // runs into one reports it in SSResult::status along with any solutions
+    // found so far.
+    uint64_t max_nodes = 0; // 0 means no limit
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool> *cancel = nullptr; // may be set by another thread
+    // fill in the cells singles and box/line reductions force before the
+    // search, and leave the eliminated candidates out of it
+    bool propagate = true;
+    // Classic 9x9 puzzles go to BitboardSolver rather than the exact cover
+    // search. It runs on one thread and fills in singles itself, so threads
+    // and propagate do not apply to it.
+    bool bitboard = true;
+    // Races this many searches on the puzzle and returns the first to finish,
+    // cancelling the others. All but the first search a copy with the bands,
+    // rows, stacks, columns and digits shuffled, which branches in another
+    // order. Each search uses the other options as given, except
+    // on_solution, which runs a single search.
+    unsigned portfolio = 1;
+    uint64_t portfolio_seed = 0; // seeds the shuffles
+    // Complete results are stored here and returned again for the same
+    // puzzle, variant, solution limits and search settings (bitboard,
+    // propagate, threads and the portfolio), so the statistics match the
+    // search that would run. Not used with on_solution, which has to see
+    // every solution.
+    SolutionCache *cache = nullptr;
+  };
+
+  struct Variant {
+    // Extra regions no digit may repeat in, as lists of (row, col) cells. A
+    // region of size cells holds every digit exactly once, a smaller one
+    // holds each digit at most once.
+    std::vector<std::vector<std::pair<int, int>>> regions;
+
+    static Variant sudokuX(int size); // both main diagonals
+    static Variant windoku(int size); // boxes between the regular boxes
   };
 
 private:
   Sudoku m_puzzle;
   int m_size{};
+  Variant m_variant{};
+  // set when another search of a portfolio has finished
+  const std::atomic<bool> *m_race{nullptr};
 
 public:
   SudokuSolver(Sudoku puzzle);
+  SudokuSolver(Sudoku puzzle, Variant variant);
   SudokuSolver(int **const arr, int size);
   SSResult search();
+  SSResult search(const SSOptions &options);
+  unsigned countSolutions(unsigned limit = 0);
+  bool hasUniqueSolution();
 
 private:
-  std::vector<std::vector<int>> toExactCover();
-  std::vector<int> toExactCoverRow(int row, int col, int num);
-  void rowToSudoku(std::vector<int> row, Sudoku *sudoku);
-  std::string getNumFromEC(std::vector<int> row);
-  Sudoku toSudoku(std::vector<std::vector<int>> matrix,
-                  std::vector<int> solution);
+  // runs searchBoard<N>() for N = m_size
+  struct BoardSearch;
+  template <int N> SSResult searchBoard(const SSOptions &options);
+  SSResult searchPortfolio(const SSOptions &options);
+  SSResult searchBitboard(const SSOptions &options);
+  // the exact cover search for square sizes without a Board<N>
+  SSResult searchAnySize(const SSOptions &options);
+  // Adds the columns of the variant regions to the rows of the classic
+  // exact cover, one list of column indices per row in row id order.
+  // Puzzles select the rows of their givens.
+  std::vector<std::vector<int>>
+  toExactCover(std::vector<std::vector<int>> matrix);
+  int numPrimaryRegions();
 };
 
 #endif /* SRC_SUDOKUSOLVER_HPP_ */
@@ -0,0 +1,26 @@
+/*
+ * Verifier.hpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#ifndef SRC_VERIFIER_HPP_
+#define SRC_VERIFIER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// Checks completed grids stored as size * size bytes each, row-major, with
+// digits 1 to size. Only sizes 4, 9, 16 and 25 are correct grids.
+
+// true if grid holds every digit once in every row, column and box
+bool verifyGrid(int size, const uint8_t *grid);
+
+// Checks count grids packed one after the other, setting ok[i] to 1 when
+// grid i is correct and to 0 otherwise. Grids are checked several at a time
+// with SSE2 or AVX2 when the build targets them. Returns the number of
+// correct grids.
+size_t verifyGrids(int size, const uint8_t *grids, size_t count, uint8_t *ok);
+
+#endif /* SRC_VERIFIER_HPP_ */
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * BitboardSolver.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "BitboardSolver.hpp"
+#include <cassert>
+
+namespace {
+const uint32_t full_band{(uint32_t(1) << 27) - 1};
+
+int lowestBit(uint32_t word) {
+  assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(word);
+#else
+  int bit{0};
+  while ((word & 1) == 0) {
+    word >>= 1;
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+struct Tables {
+  // peers of every cell, as masks over the bands
+  std::array<std::array<uint32_t, 3>, 81> peers;
+  // boxes in which a row of a band has cells, from the row's nine bits
+  std::array<uint8_t, 512> boxes_of_row;
+  // A digit takes one cell in each row and each box of a band, so the
+  // segments it goes into, bit 3 * row + box, form a permutation. From the
+  // segments with cells, those some permutation uses. The same holds for
+  // the columns and boxes of a stack.
+  std::array<uint16_t, 512> segments;
+  // the same as the cells of a band
+  std::array<uint32_t, 512> band_cells;
+
+  Tables() : peers(), boxes_of_row(), segments(), band_cells() {
+    std::array<std::array<uint32_t, 3>, 27> units{}; // rows, columns, boxes
+    for (int cell = 0; cell < 81; ++cell) {
+      const int row{cell / 9}, col{cell % 9};
+      const uint32_t bit{uint32_t(1) << (cell % 27)};
+      units[row][cell / 27] |= bit;
+      units[9 + col][cell / 27] |= bit;
+      units[18 + Board<9>::boxOf(row, col)][cell / 27] |= bit;
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+      const int row{cell / 9}, col{cell % 9};
+      for (int b = 0; b < 3; ++b) {
+        peers[cell][b] = units[row][b] | units[9 + col][b] |
+                         units[18 + Board<9>::boxOf(row, col)][b];
+      }
+      peers[cell][cell / 27] &= ~(uint32_t(1) << (cell % 27));
+    }
+    for (int row = 0; row < 512; ++row)
+      for (int box = 0; box < 3; ++box)
+        if ((row >> (3 * box) & 7) != 0)
+          boxes_of_row[row] |= static_cast<uint8_t>(1 << box);
+    const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2},
+                             {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    for (int with_cells = 0; with_cells < 512; ++with_cells) {
+      for (auto &perm : perms) {
+        bool fits{true};
+        for (int row = 0; row < 3; ++row)
+          fits = fits && (with_cells >> (3 * row + perm[row]) & 1) != 0;
+        if (!fits)
+          continue;
+        for (int row = 0; row < 3; ++row) {
+          segments[with_cells] |=
+              static_cast<uint16_t>(1 << (3 * row + perm[row]));
+          band_cells[with_cells] |= uint32_t(7) << (9 * row + 3 * perm[row]);
+        }
+      }
+    }
+  }
+};
+
+const Tables tables{};
+} // namespace
+
+BitboardSolver::BitboardSolver(const Board<9> &puzzle)
+    : start(), broken(false), sink(nullptr), stop(nullptr), max_nodes(0),
+      poll_nodes(0), nodes(0), status(Status::Complete) {
+  start.digits.fill(full_band);
+  start.unsolved.fill(full_band);
+  start.dirty = 0x1ff;
+  for (int cell = 0; cell < 81; ++cell) {
+    const int num{puzzle.getCell(cell / 9, cell % 9)};
+    if (num == 0)
+      continue;
+    const uint32_t bit{uint32_t(1) << (cell % 27)};
+    if (num > 9 || (start.digits[3 * (num - 1) + cell / 27] & bit) == 0) {
+      broken = true;
+      return;
+    }
+    place(start, cell, num - 1);
+  }
+}
+
+void BitboardSolver::place(State &state, int cell, int d) {
+  const int band{cell / 27};
+  const uint32_t bit{uint32_t(1) << (cell % 27)};
+  state.unsolved[band] &= ~bit;
+  // every digit that could go here changes, and d in the peers
+  uint32_t changed{uint32_t(1) << d};
+  for (int e = 0; e < 9; ++e) {
+    uint32_t &cells = state.digits[3 * e + band];
+    changed |= (cells >> (cell % 27) & 1) << e;
+    cells &= ~bit;
+  }
+  state.dirty |= changed;
+  for (int b = 0; b < 3; ++b)
+    state.digits[3 * d + b] &= ~tables.peers[cell][b];
+  state.digits[3 * d + band] |= bit;
+}
+
+bool BitboardSolver::propagate(State &state) {
+  for (;;) {
+    // naked singles, counting the candidates of every cell bit-sliced
+    bool placed{false};
+    for (int b = 0; b < 3; ++b) {
+      uint32_t ones{0}, twos{0};
+      for (int d = 0; d < 9; ++d) {
+        const uint32_t cells{state.digits[3 * d + b]};
+        twos |= ones & cells;
+        ones |= cells;
+      }
+      if ((state.unsolved[b] & ~ones) != 0)
+        return false; // an empty cell without candidates
+      for (uint32_t singles = state.unsolved[b] & ~twos; singles != 0;
+           singles &= singles - 1) {
+        const int i{lowestBit(singles)};
+        const uint32_t bit{uint32_t(1) << i};
+        // an earlier single may have taken the last candidate
+        int d{0};
+        while (d < 9 && (state.digits[3 * d + b] & bit) == 0)
+          ++d;
+        if (d == 9)
+          return false;
+        place(state, 27 * b + i, d);
+        placed = true;
+      }
+    }
+    if (placed)
+      continue;
+    if (state.dirty == 0)
+      return true;
+
+    // hidden singles: a digit with one place left in a unit, looking only
+    // at the digits that changed since they were last checked
+    while (state.dirty != 0) {
+      const int d{lowestBit(state.dirty)};
+      state.dirty &= state.dirty - 1;
+      if (!hiddenSingles(state, d))
+        return false;
+    }
+    if ((state.unsolved[0] | state.unsolved[1] | state.unsolved[2]) == 0)
+      return true;
+  }
+}
+
+bool BitboardSolver::hiddenSingles(State &state, int d) {
+  // A band word holds three rows of nine cells. For each band, the cells of
+  // the digit in any and in at least two of its rows, by column, once with
+  // the filled cells and once with only the open ones.
+  uint32_t open[3], any[3], ones[3], twos[3];
+  uint32_t row_singles[3];
+  bool missing{false};
+  // box/line reductions first, along the rows of each band and then along
+  // the columns of each stack
+  uint32_t *bands{&state.digits[3 * d]};
+  uint32_t cols[3], keep[3] = {};
+  for (int b = 0; b < 3; ++b) {
+    bands[b] &= tables.band_cells[tables.boxes_of_row[bands[b] & 0x1ff] |
+                                  tables.boxes_of_row[bands[b] >> 9 & 0x1ff]
+                                      << 3 |
+                                  tables.boxes_of_row[bands[b] >> 18] << 6];
+    cols[b] = (bands[b] | bands[b] >> 9 | bands[b] >> 18) & 0x1ff;
+  }
+  for (int s = 0; s < 9; s += 3) {
+    const uint32_t with_cells{(cols[0] >> s & 7) | (cols[1] >> s & 7) << 3 |
+                              (cols[2] >> s & 7) << 6};
+    const uint32_t kept{tables.segments[with_cells]};
+    for (int b = 0; b < 3; ++b)
+      keep[b] |= (kept >> (3 * b) & 7) << s;
+  }
+  for (int b = 0; b < 3; ++b) {
+    bands[b] &= keep[b] * 0x40201; // the columns in all three rows
+    const uint32_t cells{bands[b]};
+    open[b] = cells & state.unsolved[b];
+    const uint32_t r0{cells & 0x1ff}, r1{cells >> 9 & 0x1ff}, r2{cells >> 18};
+    missing |= r0 == 0 || r1 == 0 || r2 == 0;
+    any[b] = r0 | r1 | r2;
+    const uint32_t o0{open[b] & 0x1ff}, o1{open[b] >> 9 & 0x1ff},
+        o2{open[b] >> 18};
+    ones[b] = o0 | o1 | o2;
+    twos[b] = (o0 & o1) | (o0 & o2) | (o1 & o2);
+    // rows with a single open cell
+    row_singles[b] = ((o0 & (o0 - 1)) == 0 ? o0 : 0) |
+                     ((o1 & (o1 - 1)) == 0 ? o1 << 9 : 0) |
+                     ((o2 & (o2 - 1)) == 0 ? o2 << 18 : 0);
+  }
+  // every row, column and box needs a place for the digit
+  if (missing || (any[0] | any[1] | any[2]) != 0x1ff)
+    return false;
+  const uint32_t box_lows{0x49}; // lowest column of each box
+  for (int b = 0; b < 3; ++b) {
+    const uint32_t in_box{any[b] | any[b] >> 1 | any[b] >> 2};
+    if ((in_box & box_lows) != box_lows)
+      return false;
+  }
+
+  // columns with one open cell over all three bands
+  const uint32_t col_ones{ones[0] | ones[1] | ones[2]};
+  const uint32_t col_twos{twos[0] | twos[1] | twos[2] | (ones[0] & ones[1]) |
+                          (ones[0] & ones[2]) | (ones[1] & ones[2])};
+  const uint32_t col_singles{col_ones & ~col_twos};
+  for (int b = 0; b < 3; ++b) {
+    // boxes of the band with one open cell: one column of the box in one row
+    const uint32_t c0{ones[b] & box_lows}, c1{ones[b] >> 1 & box_lows},
+        c2{ones[b] >> 2 & box_lows};
+    const uint32_t doubled{(twos[b] | twos[b] >> 1 | twos[b] >> 2) &
+                           box_lows};
+    const uint32_t box_singles{((c0 ^ c1 ^ c2) & ~(c0 & c1 & c2) & ~doubled) *
+                               7};
+    const uint32_t cols{col_singles | box_singles};
+    uint32_t found{row_singles[b] | (open[b] & (cols | cols << 9 | cols << 18))};
+    // the singles were found on a copy, so each is checked again
+    for (; found != 0; found &= found - 1) {
+      const int i{lowestBit(found)};
+      if ((state.digits[3 * d + b] & state.unsolved[b] & (uint32_t(1) << i)) !=
+          0)
+        place(state, 27 * b + i, d);
+    }
+  }
+  return true;
+}
+
+BitboardSolver::Status
+BitboardSolver::search(const std::function<bool(const Board<9> &)> &sink,
+                       uint64_t max_nodes,
+                       const std::function<bool(uint64_t)> &stop,
+                       uint64_t poll_nodes) {
+  this->sink = &sink;
+  this->stop = stop ? &stop : nullptr;
+  this->max_nodes = max_nodes;
+  this->poll_nodes = poll_nodes == 0 ? 1 : poll_nodes;
+  nodes = 0;
+  status = Status::Complete;
+  if (!broken) {
+    State state{start};
+    branch(state);
+  }
+  return status;
+}
+
+bool BitboardSolver::branch(State &state) {
+  if (!propagate(state))
+    return true;
+  if ((state.unsolved[0] | state.unsolved[1] | state.unsolved[2]) == 0) {
+    Board<9> solution{};
+    for (int d = 0; d < 9; ++d)
+      for (int b = 0; b < 3; ++b)
+        for (uint32_t cells = state.digits[3 * d + b]; cells != 0;
+             cells &= cells - 1) {
+          const int cell{27 * b + lowestBit(cells)};
+          solution.setCell(cell / 9, cell % 9, d + 1);
+        }
+    return (*sink)(solution);
+  }
+
+  // a cell with two candidates if there is one, else the fewest
+  int best{-1}, best_count{10};
+  for (int b = 0; b < 3 && best_count > 2; ++b) {
+    uint32_t ones{0}, twos{0}, threes{0};
+    for (int d = 0; d < 9; ++d) {
+      const uint32_t cells{state.digits[3 * d + b]};
+      threes |= twos & cells;
+      twos |= ones & cells;
+      ones |= cells;
+    }
+    const uint32_t pairs{state.unsolved[b] & twos & ~threes};
+    if (pairs != 0) {
+      best = 27 * b + lowestBit(pairs);
+      best_count = 2;
+    }
+  }
+  if (best < 0) {
+    for (int b = 0; b < 3; ++b) {
+      for (uint32_t cells = state.unsolved[b]; cells != 0;
+           cells &= cells - 1) {
+        const int i{lowestBit(cells)};
+        int count{0};
+        for (int d = 0; d < 9; ++d)
+          count += state.digits[3 * d + b] >> i & 1;
+        if (count < best_count) {
+          best = 27 * b + i;
+          best_count = count;
+        }
+      }
+    }
+  }
+
+  const int band{best / 27};
+  const uint32_t bit{uint32_t(1) << (best % 27)};
+  for (int d = 0; d < 9; ++d) {
+    if ((state.digits[3 * d + band] & bit) == 0)
+      continue;
+    if (max_nodes != 0 && nodes == max_nodes) {
+      status = Status::OutOfNodes;
+      return false;
+    }
+    ++nodes;
+    if (stop && nodes % poll_nodes == 0 && (*stop)(nodes)) {
+      status = Status::Stopped;
+      return false;
+    }
+    State next{state};
+    place(next, best, d);
+    if (!branch(next))
+      return false;
+  }
+  return true;
+}
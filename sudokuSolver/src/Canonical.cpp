@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Canonical.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "Canonical.hpp"
+#include "Board.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace {
+const int max_cells{max_canonical_size * max_canonical_size};
+// rows or columns, by their index in the source
+typedef std::array<uint8_t, max_canonical_size> Order;
+
+// every order of 0 .. B - 1
+template <int B> const std::vector<std::array<uint8_t, B>> &boxPerms() {
+  static const std::vector<std::array<uint8_t, B>> perms{[] {
+    std::vector<std::array<uint8_t, B>> all{};
+    std::array<uint8_t, B> perm{};
+    for (int i = 0; i < B; ++i)
+      perm[i] = static_cast<uint8_t>(i);
+    do
+      all.push_back(perm);
+    while (std::next_permutation(perm.begin(), perm.end()));
+    return all;
+  }()};
+  return perms;
+}
+
+// Branch and bound over the transforms, building the grid row by row with
+// the digits labelled in the order they first appear. The first row fixes
+// the column order one stack at a time, following a choice only while the
+// row so far is no larger than the best one. Every later row then keeps,
+// out of all the transforms that tie so far, those giving the smallest row.
+template <int N> class Canonicalizer {
+public:
+  static constexpr int box = Board<N>::box;
+  static_assert(N <= max_canonical_size, "too many symmetries");
+
+  Canonicalizer(Sudoku &puzzle) {
+    for (int row = 0; row < N; ++row) {
+      for (int col = 0; col < N; ++col) {
+        const uint8_t num{static_cast<uint8_t>(puzzle.getCell(row, col))};
+        grid[0][row * N + col] = num;
+        grid[1][col * N + row] = num;
+      }
+    }
+  }
+
+  void run() {
+    std::fill(best, best + N, 0xFF);
+    State state{};
+    for (state.transposed = 0; state.transposed < 2; ++state.transposed) {
+      for (int r = 0; r < N; ++r) {
+        state.rows[0] = static_cast<uint8_t>(r);
+        state.used = static_cast<uint16_t>(1u << r);
+        placeStack(0, state);
+      }
+    }
+    std::vector<State> next{};
+    for (int row = 1; row < N; ++row) {
+      placeRow(row, next);
+      std::sort(next.begin(), next.end());
+      next.erase(std::unique(next.begin(), next.end(),
+                             [](const State &a, const State &b) {
+                               return a.sameFuture(b);
+                             }),
+                 next.end());
+      states.swap(next);
+    }
+    record(states.front());
+  }
+
+  const uint8_t *getBest() const { return best; }
+  const Transform &getTransform() const { return transform; }
+
+private:
+  // label of every digit seen so far, 0 for the others
+  struct Labels {
+    std::array<uint8_t, N + 1> of;
+    uint8_t last;
+
+    uint8_t relabel(uint8_t num) {
+      if (num != 0 && of[num] == 0)
+        of[num] = ++last;
+      return of[num];
+    }
+  };
+
+  // a transform as far as it has been built
+  struct State {
+    int transposed;
+    std::array<uint8_t, N> rows;
+    std::array<uint8_t, N> cols;
+    Labels labels;
+    uint16_t used; // bit r for every source row placed
+
+    // States that only differ in the order of the rows placed so far, such
+    // as those of puzzles with few clues, end the same way.
+    bool sameFuture(const State &other) const {
+      return transposed == other.transposed && used == other.used &&
+             cols == other.cols && labels.of == other.labels.of;
+    }
+    bool operator<(const State &other) const {
+      if (transposed != other.transposed)
+        return transposed < other.transposed;
+      if (used != other.used)
+        return used < other.used;
+      if (cols != other.cols)
+        return cols < other.cols;
+      return labels.of < other.labels.of;
+    }
+  };
+
+  // orders the columns of stack in the first row
+  void placeStack(int stack, State &state) {
+    if (stack == box) {
+      states.push_back(state);
+      return;
+    }
+    const uint8_t *source{grid[state.transposed] + state.rows[0] * N};
+    const Labels labels{state.labels};
+    for (int s = 0; s < box; ++s) {
+      if (stack_used[s])
+        continue;
+      stack_used[s] = true;
+      for (const std::array<uint8_t, box> &perm : boxPerms<box>()) {
+        state.labels = labels;
+        uint8_t line[box];
+        for (int i = 0; i < box; ++i) {
+          const int col{s * box + perm[i]};
+          state.cols[stack * box + i] = static_cast<uint8_t>(col);
+          line[i] = state.labels.relabel(source[col]);
+        }
+        uint8_t *target{best + stack * box};
+        const int order{std::memcmp(line, target, box)};
+        if (order > 0)
+          continue;
+        if (order < 0) {
+          // the rest of the row is unknown again
+          std::memcpy(target, line, box);
+          std::fill(target + box, best + N, 0xFF);
+          states.clear();
+        }
+        placeStack(stack + 1, state);
+      }
+      stack_used[s] = false;
+    }
+    state.labels = labels;
+  }
+
+  // moves to next the states extended by the smallest row
+  void placeRow(int row, std::vector<State> &next) {
+    uint8_t *target{best + row * N};
+    std::fill(target, target + N, 0xFF);
+    next.clear();
+    const unsigned band{(1u << box) - 1};
+    for (const State &state : states) {
+      int first{0}, last{N};
+      if (row % box != 0) {
+        // stay in the band of the row above
+        first = state.rows[row - 1] / box * box;
+        last = first + box;
+      }
+      for (int r = first; r < last; ++r) {
+        if ((state.used >> r & 1) != 0 ||
+            (row % box == 0 && (state.used >> r / box * box & band) != 0))
+          continue;
+        Labels labels{state.labels};
+        uint8_t line[N];
+        const uint8_t *source{grid[state.transposed] + r * N};
+        for (int col = 0; col < N; ++col)
+          line[col] = labels.relabel(source[state.cols[col]]);
+        const int order{std::memcmp(line, target, N)};
+        if (order > 0)
+          continue;
+        if (order < 0) {
+          std::memcpy(target, line, N);
+          next.clear();
+        }
+        next.push_back(state);
+        next.back().rows[row] = static_cast<uint8_t>(r);
+        next.back().labels = labels;
+        next.back().used = static_cast<uint16_t>(state.used | 1u << r);
+      }
+    }
+  }
+
+  void record(const State &state) {
+    transform.size = N;
+    transform.transposed = state.transposed != 0;
+    std::copy(state.rows.begin(), state.rows.end(), transform.rows.begin());
+    std::copy(state.cols.begin(), state.cols.end(), transform.cols.begin());
+    std::copy(state.labels.of.begin(), state.labels.of.end(),
+              transform.digits.begin());
+    // digits missing from the puzzle take the labels that are left
+    uint8_t last{state.labels.last};
+    for (int num = 1; num <= N; ++num)
+      if (transform.digits[num] == 0)
+        transform.digits[num] = ++last;
+  }
+
+  uint8_t grid[2][N * N]{};
+  uint8_t best[N * N]{};
+  bool stack_used[box]{};
+  std::vector<State> states{};
+  Transform transform{};
+};
+
+struct Canonicalize {
+  Sudoku &puzzle;
+  Sudoku &canonical;
+  Transform &transform;
+
+  template <int N> bool visit() {
+    return run<N>(std::integral_constant<bool, N <= max_canonical_size>{});
+  }
+  template <int N> bool run(std::true_type) {
+    Canonicalizer<N> canonicalizer{puzzle};
+    canonicalizer.run();
+    canonical = Sudoku{canonicalizer.getBest(), N};
+    transform = canonicalizer.getTransform();
+    return true;
+  }
+  template <int N> bool run(std::false_type) { return false; }
+};
+} // namespace
+
+Transform Transform::identity(int size) {
+  Transform transform{};
+  transform.size = size;
+  for (int i = 0; i < size; ++i) {
+    transform.rows[i] = static_cast<uint8_t>(i);
+    transform.cols[i] = static_cast<uint8_t>(i);
+  }
+  for (int num = 0; num <= size; ++num)
+    transform.digits[num] = static_cast<uint8_t>(num);
+  return transform;
+}
+
+Sudoku Transform::apply(Sudoku &puzzle) const {
+  assert(puzzle.getSize() == size);
+  uint8_t cells[max_transform_size * max_transform_size];
+  for (int row = 0; row < size; ++row) {
+    for (int col = 0; col < size; ++col) {
+      const int r{rows[row]}, c{cols[col]};
+      const int num{transposed ? puzzle.getCell(c, r) : puzzle.getCell(r, c)};
+      cells[row * size + col] = digits[num];
+    }
+  }
+  return Sudoku{cells, size};
+}
+
+Sudoku Transform::revert(Sudoku &sudoku) const {
+  assert(sudoku.getSize() == size);
+  uint8_t original[max_transform_size + 1]{};
+  for (int num = 0; num <= size; ++num)
+    original[digits[num]] = static_cast<uint8_t>(num);
+  uint8_t cells[max_transform_size * max_transform_size];
+  for (int row = 0; row < size; ++row) {
+    for (int col = 0; col < size; ++col) {
+      const int r{rows[row]}, c{cols[col]};
+      const int cell{transposed ? c * size + r : r * size + c};
+      cells[cell] = original[sudoku.getCell(row, col)];
+    }
+  }
+  return Sudoku{cells, size};
+}
+
+bool canonicalize(Sudoku &puzzle, Sudoku &canonical, Transform &transform) {
+  Canonicalize canonicalize{puzzle, canonical, transform};
+  return dispatchBoardSize(puzzle.getSize(), canonicalize, false);
+}
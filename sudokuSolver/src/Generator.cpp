@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Generator.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "Generator.hpp"
+#include "Board.hpp"
+#include "Solver.hpp"
+#include <cassert>
+#include <cmath>
+#include <string>
+
+namespace {
+struct BuildDLX {
+  template <int N> DLX *visit() {
+    return new DLX{Solver<N>::num_columns, Solver<N>::exactCover()};
+  }
+};
+} // namespace
+
+Generator::Generator(int size, uint64_t seed)
+    : size(size), box(static_cast<int>(std::sqrt(size))), rng(seed) {
+  BuildDLX build{};
+  dlx.reset(dispatchBoardSize<DLX *>(size, build, nullptr));
+}
+
+void Generator::shuffle(std::vector<int> &items) {
+  // by hand, std::shuffle may differ between standard libraries
+  for (size_t i = items.size(); i > 1; --i)
+    std::swap(items[i - 1], items[rng() % i]);
+}
+
+Sudoku Generator::grid() {
+  if (!dlx)
+    return Sudoku{std::string{}};
+  // The boxes on the diagonal share no row or column, so any filling of
+  // them is consistent, and the search completes it.
+  std::vector<int> digits(size);
+  for (;;) {
+    dlx->reset();
+    answer.assign(size * size, 0);
+    for (int b = 0; b < box; ++b) {
+      for (int num = 1; num <= size; ++num)
+        digits[num - 1] = num;
+      shuffle(digits);
+      for (int i = 0; i < size; ++i) {
+        const int cell{(b * box + i / box) * size + b * box + i % box};
+        answer[cell] = static_cast<uint8_t>(digits[i]);
+        dlx->select(rowOf(cell));
+      }
+    }
+    if (dlx->solve())
+      break;
+  }
+  // the search only reports the rows it chose, not the selected ones
+  for (int id : dlx->getSolution())
+    answer[id / size] = static_cast<uint8_t>(id % size + 1);
+  dlx->reset();
+  return Sudoku{answer.data(), size};
+}
+
+Sudoku Generator::puzzle(int target_clues) {
+  Sudoku solution = grid();
+  return dig(solution, target_clues);
+}
+
+Sudoku Generator::dig(Sudoku &solution, int target_clues) {
+  if (!dlx || solution.getSize() != size || !solution.isCorrect())
+    return Sudoku{std::string{}};
+  answer.resize(size * size);
+  for (int cell = 0; cell < size * size; ++cell)
+    answer[cell] = static_cast<uint8_t>(solution.getCell(cell / size,
+                                                         cell % size));
+  order.resize(size * size);
+  for (int cell = 0; cell < size * size; ++cell)
+    order[cell] = cell;
+  shuffle(order);
+  kept.assign(size * size, true);
+  unit_digits.assign(3 * size, (uint32_t(1) << size) - 1);
+  clues = size * size;
+  target = target_clues;
+
+  dlx->reset();
+  decide(0, size * size);
+  dlx->reset();
+  std::vector<uint8_t> cells(answer);
+  for (int cell = 0; cell < size * size; ++cell)
+    if (!kept[cell])
+      cells[cell] = 0;
+  return Sudoku{cells.data(), size};
+}
+
+bool Generator::isForced(int cell) {
+  const int row{cell / size}, col{cell % size};
+  const int units[3] = {row, size + col,
+                        2 * size + row / box * box + col / box};
+  const uint32_t bit{uint32_t(1) << (answer[cell] - 1)};
+  // naked single: every other digit is in a unit of the cell
+  if ((unit_digits[units[0]] | unit_digits[units[1]] | unit_digits[units[2]] |
+       bit) == (uint32_t(1) << size) - 1)
+    return true;
+  // hidden single: in some unit, every other empty cell sees the digit in a
+  // unit the cell is not in
+  for (int u : units) {
+    bool elsewhere{false};
+    for (int i = 0; i < size && !elsewhere; ++i) {
+      const int other{unitCell(u, i)};
+      if (other == cell || kept[other])
+        continue;
+      const int r{other / size}, c{other % size};
+      const int others[3] = {r, size + c, 2 * size + r / box * box + c / box};
+      elsewhere = true;
+      for (int v : others) {
+        if (v != units[0] && v != units[1] && v != units[2] &&
+            (unit_digits[v] & bit) != 0) {
+          elsewhere = false;
+          break;
+        }
+      }
+    }
+    if (!elsewhere)
+      return true;
+  }
+  return false;
+}
+
+bool Generator::hasOtherSolution(int cell) {
+  const bool removed{dlx->remove(rowOf(cell))};
+  assert(removed);
+  (void)removed;
+  const bool found{dlx->solve()};
+  dlx->unselect();
+  return found;
+}
+
+void Generator::decide(int first, int last) {
+  if (last - first == 1) {
+    const int cell{order[first]};
+    if (clues > target && (isForced(cell) || !hasOtherSolution(cell))) {
+      kept[cell] = false;
+      --clues;
+      const int row{cell / size}, col{cell % size};
+      const uint32_t bit{uint32_t(1) << (answer[cell] - 1)};
+      unit_digits[row] &= ~bit;
+      unit_digits[size + col] &= ~bit;
+      unit_digits[2 * size + row / box * box + col / box] &= ~bit;
+    } else {
+      dlx->select(rowOf(cell));
+    }
+    return;
+  }
+  // Every check needs all the other clues selected, so the right half stays
+  // in while the left one is decided. Splitting in halves keeps the selects
+  // and unselects to n log n per puzzle rather than n * n.
+  const int mid{first + (last - first) / 2};
+  for (int i = mid; i < last; ++i)
+    dlx->select(rowOf(order[i]));
+  decide(first, mid);
+  // take the right half out from under the clues kept on the left
+  for (int i = first; i < mid; ++i)
+    if (kept[order[i]])
+      dlx->unselect();
+  for (int i = mid; i < last; ++i)
+    dlx->unselect();
+  for (int i = first; i < mid; ++i)
+    if (kept[order[i]])
+      dlx->select(rowOf(order[i]));
+  decide(mid, last);
+}
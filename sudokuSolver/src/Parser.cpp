@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Parser.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "Parser.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+const uint8_t bad_char{0xFF};
+
+// value of every byte, bad_char for the ones a puzzle cannot hold
+struct CharTable {
+  static const CharTable &get() {
+    static const CharTable table{};
+    return table;
+  }
+  std::array<uint8_t, 256> value;
+
+private:
+  CharTable() {
+    value.fill(bad_char);
+    value['.'] = 0;
+    for (int c = '0'; c <= '9'; ++c)
+      value[c] = static_cast<uint8_t>(c - '0');
+    for (int c = 'A'; c <= 'P'; ++c) {
+      value[c] = static_cast<uint8_t>(c - 'A' + 10);
+      value[c - 'A' + 'a'] = static_cast<uint8_t>(c - 'A' + 10);
+    }
+  }
+};
+
+bool isTrailingSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+int sizeOf(size_t num_cells) {
+  switch (num_cells) {
+  case 16:
+    return 4;
+  case 81:
+    return 9;
+  case 256:
+    return 16;
+  case 625:
+    return 25;
+  default:
+    return 0;
+  }
+}
+} // namespace
+
+std::string ParseError::message() const {
+  std::string where{};
+  if (line > 0)
+    where = "line " + std::to_string(line) + ", ";
+  if (column > 0)
+    where += "column " + std::to_string(column) + ", ";
+  switch (reason) {
+  case Reason::None:
+    return "no error";
+  case Reason::BadLength:
+    return where + "puzzle must have 16, 81, 256 or 625 cells";
+  case Reason::BadCharacter:
+    return where + "unexpected character";
+  case Reason::DigitOutOfRange:
+    return where + "digit larger than the puzzle";
+  }
+  return where;
+}
+
+ParseError parsePuzzle(const char *begin, const char *end, uint8_t *cells,
+                       int *size) {
+  while (end != begin && isTrailingSpace(end[-1]))
+    --end;
+  ParseError error{};
+  const size_t num_cells{static_cast<size_t>(end - begin)};
+  const int puzzle_size{sizeOf(num_cells)};
+  if (puzzle_size == 0) {
+    error.reason = ParseError::Reason::BadLength;
+    return error;
+  }
+  // the whole line is checked at once, bad lines are rare
+  const std::array<uint8_t, 256> &value = CharTable::get().value;
+  uint8_t largest{0};
+  for (size_t i = 0; i < num_cells; ++i) {
+    cells[i] = value[static_cast<unsigned char>(begin[i])];
+    largest = std::max(largest, cells[i]);
+  }
+  if (largest > puzzle_size) {
+    const uint8_t *bad = std::find_if(
+        cells, cells + num_cells, [&](uint8_t v) { return v > puzzle_size; });
+    error.column = static_cast<size_t>(bad - cells) + 1;
+    error.reason = *bad == bad_char ? ParseError::Reason::BadCharacter
+                                    : ParseError::Reason::DigitOutOfRange;
+    return error;
+  }
+  *size = puzzle_size;
+  return error;
+}
+
+void parsePuzzles(
+    const char *begin, const char *end,
+    const std::function<void(const uint8_t *, int, size_t)> &on_puzzle,
+    const std::function<void(const ParseError &)> &on_error) {
+  uint8_t cells[max_puzzle_cells];
+  size_t line{0};
+  while (begin != end) {
+    ++line;
+    const char *line_end = static_cast<const char *>(
+        std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+    if (line_end == nullptr)
+      line_end = end;
+    const char *last = line_end;
+    while (last != begin && isTrailingSpace(last[-1]))
+      --last;
+    if (last != begin) {
+      int size{0};
+      ParseError error = parsePuzzle(begin, last, cells, &size);
+      if (error.failed()) {
+        error.line = line;
+        on_error(error);
+      } else
+        on_puzzle(cells, size, line);
+    }
+    begin = line_end == end ? end : line_end + 1;
+  }
+}
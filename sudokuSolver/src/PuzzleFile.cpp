@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * PuzzleFile.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "PuzzleFile.hpp"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if !defined(_WIN32)
+#define PUZZLE_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char magic[4]{'S', 'D', 'K', 'P'};
+
+int bitsPerCell(int size) { return size <= 9 ? 4 : 5; }
+
+bool supportedSize(int size) {
+  return size == 4 || size == 9 || size == 16 || size == 25;
+}
+
+uint64_t readNumber(const uint8_t *in, int bytes) {
+  uint64_t value{0};
+  for (int i = bytes - 1; i >= 0; --i)
+    value = value << 8 | in[i];
+  return value;
+}
+
+void writeNumber(std::vector<uint8_t> &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+} // namespace
+
+const uint16_t PuzzleFile::version;
+const size_t PuzzleFile::header_bytes;
+
+PuzzleFile::~PuzzleFile() { close(); }
+
+size_t PuzzleFile::recordBytes(int size) {
+  return (size_t(size) * size * bitsPerCell(size) + 7) / 8;
+}
+
+bool PuzzleFile::open(const std::string &path) {
+  close();
+  if (!load(path) || !checkContents()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool PuzzleFile::load(const std::string &path) {
+#ifdef PUZZLE_FILE_MMAP
+  const int fd{::open(path.c_str(), O_RDONLY)};
+  if (fd < 0)
+    return false;
+  struct stat info {};
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    void *map = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                     MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      data = static_cast<const uint8_t *>(map);
+      length = static_cast<size_t>(info.st_size);
+      mapped = true;
+    }
+  }
+  ::close(fd);
+  if (mapped)
+    return true;
+#endif
+  // no mmap, or it failed: read the whole file instead
+  std::ifstream file(path, std::ifstream::binary);
+  if (!file.good())
+    return false;
+  contents.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+  data = contents.data();
+  length = contents.size();
+  return true;
+}
+
+bool PuzzleFile::checkContents() {
+  if (length < header_bytes || std::memcmp(data, magic, 4) != 0 ||
+      readNumber(data + 4, 2) != version)
+    return false;
+  size = data[6];
+  count = readNumber(data + 8, 8);
+  if (!supportedSize(size) || data[7] != bitsPerCell(size))
+    return false;
+  // every record has to be inside the file
+  const uint64_t records{(length - header_bytes) / 8};
+  if (count > records)
+    return false;
+  for (uint64_t i = 0; i < count; ++i) {
+    const uint64_t offset{readNumber(data + header_bytes + 8 * i, 8)};
+    if (offset > length || length - offset < recordBytes(size))
+      return false;
+  }
+  return true;
+}
+
+void PuzzleFile::close() {
+#ifdef PUZZLE_FILE_MMAP
+  if (mapped)
+    munmap(const_cast<uint8_t *>(data), length);
+#endif
+  mapped = false;
+  data = nullptr;
+  length = 0;
+  contents.clear();
+  size = 0;
+  count = 0;
+}
+
+void PuzzleFile::read(uint64_t i, uint8_t *cells) const {
+  assert(i < count);
+  const uint8_t *record{data + readNumber(data + header_bytes + 8 * i, 8)};
+  const int bits{bitsPerCell(size)};
+  const unsigned mask{(1u << bits) - 1};
+  size_t bit{0};
+  for (int cell = 0; cell < size * size; ++cell, bit += bits) {
+    // a cell spans at most two bytes
+    unsigned word{record[bit / 8]};
+    if (bit % 8 + bits > 8)
+      word |= unsigned(record[bit / 8 + 1]) << 8;
+    cells[cell] = static_cast<uint8_t>(word >> (bit % 8) & mask);
+  }
+}
+
+Sudoku PuzzleFile::get(uint64_t i) const {
+  uint8_t cells[25 * 25];
+  read(i, cells);
+  return Sudoku{cells, size};
+}
+
+bool PuzzleFile::isPuzzleFile(const std::string &path) {
+  char start[4]{};
+  std::ifstream file(path, std::ifstream::binary);
+  return file.read(start, 4) && std::memcmp(start, magic, 4) == 0;
+}
+
+bool PuzzleFile::write(const std::string &path,
+                       std::vector<Sudoku> &puzzles) {
+  const int size{puzzles.empty() ? 9 : puzzles.front().getSize()};
+  if (!supportedSize(size))
+    return false;
+  const int bits{bitsPerCell(size)};
+  const size_t record_bytes{recordBytes(size)};
+  std::vector<uint8_t> out{};
+  out.reserve(header_bytes + puzzles.size() * (8 + record_bytes));
+  out.insert(out.end(), magic, magic + 4);
+  writeNumber(out, version, 2);
+  writeNumber(out, static_cast<uint64_t>(size), 1);
+  writeNumber(out, static_cast<uint64_t>(bits), 1);
+  writeNumber(out, puzzles.size(), 8);
+  const size_t first{header_bytes + 8 * puzzles.size()};
+  for (size_t i = 0; i < puzzles.size(); ++i)
+    writeNumber(out, first + i * record_bytes, 8);
+  for (auto &puzzle : puzzles) {
+    if (puzzle.getSize() != size)
+      return false;
+    const size_t start{out.size()};
+    out.resize(start + record_bytes, 0);
+    size_t bit{0};
+    for (int row = 0; row < size; ++row) {
+      for (int col = 0; col < size; ++col, bit += bits) {
+        const unsigned word{unsigned(puzzle.getCell(row, col)) << (bit % 8)};
+        out[start + bit / 8] |= static_cast<uint8_t>(word);
+        if (bit % 8 + bits > 8)
+          out[start + bit / 8 + 1] |= static_cast<uint8_t>(word >> 8);
+      }
+    }
+  }
+  std::ofstream file(path, std::ofstream::binary);
+  file.write(reinterpret_cast<const char *>(out.data()),
+             static_cast<std::streamsize>(out.size()));
+  return file.good();
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * SolutionCache.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "SolutionCache.hpp"
+#include <algorithm>
+
+namespace {
+// finalizer of splitmix64, spreads every input bit over the output
+uint64_t mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+} // namespace
+
+void SolutionCache::Hasher::add(uint64_t value) {
+  // FNV-1a on whole words for one half, a multiply and rotate for the other
+  low = (low ^ value) * 0x100000001b3ULL;
+  high = (high ^ mix(value + count)) * 0x9fb21c651e98df25ULL;
+  high = high << 23 | high >> 41;
+  ++count;
+}
+
+SolutionCache::Key SolutionCache::Hasher::key() const {
+  return Key{mix(low ^ count), mix(high)};
+}
+
+SolutionCache::SolutionCache(size_t capacity, unsigned num_shards)
+    : shards{}, shard_capacity{0} {
+  num_shards = std::max(num_shards, 1u);
+  for (unsigned i = 0; i < num_shards; ++i)
+    shards.emplace_back(new Shard{});
+  shard_capacity = std::max<size_t>(capacity / num_shards, 1);
+}
+
+bool SolutionCache::find(const Key &key, SudokuSolver::SSResult &result) {
+  Shard &shard = shardOf(key);
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  auto found = shard.index.find(key);
+  if (found == shard.index.end()) {
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+  result = found->second->result;
+  hits.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void SolutionCache::insert(const Key &key,
+                           const SudokuSolver::SSResult &result) {
+  Shard &shard = shardOf(key);
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  auto found = shard.index.find(key);
+  if (found != shard.index.end()) {
+    // another thread solved the same puzzle first
+    found->second->result = result;
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    return;
+  }
+  shard.entries.push_front(Entry{key, result});
+  shard.index.emplace(key, shard.entries.begin());
+  if (shard.entries.size() > shard_capacity) {
+    shard.index.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+    evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SolutionCache::clear() {
+  for (auto &shard : shards) {
+    std::lock_guard<std::mutex> lock{shard->mutex};
+    shard->entries.clear();
+    shard->index.clear();
+  }
+}
+
+SolutionCache::Statistics SolutionCache::getStatistics() {
+  Statistics stats{};
+  stats.hits = hits.load(std::memory_order_relaxed);
+  stats.misses = misses.load(std::memory_order_relaxed);
+  stats.evictions = evictions.load(std::memory_order_relaxed);
+  for (auto &shard : shards) {
+    std::lock_guard<std::mutex> lock{shard->mutex};
+    stats.size += shard->entries.size();
+  }
+  return stats;
+}
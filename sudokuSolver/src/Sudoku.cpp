@@ -30,7 +30,8 @@
  */
 
 #include "Sudoku.hpp"
-#include <cmath>
+#include "Parser.hpp"
+#include <algorithm>
 #include <string>
 
 Sudoku::Sudoku(int **const arr, int p_size) {
@@ -38,55 +39,81 @@ Sudoku::Sudoku(int **const arr, int p_size) {
   initCells();
   for (int i = 0; i < size; i++) {
     for (int j = 0; j < size; j++)
-      cells[i][j] = arr[i][j];
+      setCell(i, j, arr[i][j]);
   }
 }
 
-Sudoku::Sudoku(std::string input) {
-  rtrim(input, ' ');
-  size = static_cast<int>(std::sqrt(input.length()));
+Sudoku::Sudoku(const uint8_t *values, int p_size) {
+  size = p_size;
   initCells();
-  switch (size) {
-  case 4:
-  case 9:
-  case 16:
-  case 25:
-    fillSudoku(input);
-    break;
-  default:
-    // TODO: exception handling unregconised input
-    break;
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++)
+      setCell(i, j, values[i * size + j]);
   }
 }
 
-Sudoku::Sudoku(const Sudoku &other) {
-  size = other.size;
+Sudoku::Sudoku(const std::string &input) {
+  uint8_t values[max_puzzle_cells];
+  if (parsePuzzle(input.data(), input.data() + input.size(), values, &size)
+          .failed())
+    size = 0; // rejected input gives an empty 0 x 0 board
   initCells();
   for (int i = 0; i < size; i++) {
     for (int j = 0; j < size; j++)
-      cells[i][j] = other.cells[i][j];
+      setCell(i, j, values[i * size + j]);
   }
 }
 
-Sudoku::~Sudoku() {
-  for (int i = 0; i < size; ++i) {
-    delete[] cells[i];
-  }
-  delete[] cells;
+Sudoku::Sudoku(const Sudoku &other) {
+  size = other.size;
+  initCells();
+  std::copy(other.masks, other.masks + blockWords(), masks);
+  num_empty = other.num_empty;
+  num_repeats = other.num_repeats;
+}
+
+Sudoku::Sudoku(Sudoku &&other) noexcept
+    : masks{other.masks}, cells{other.cells}, size{other.size},
+      box_size{other.box_size}, num_boxes{other.num_boxes},
+      num_empty{other.num_empty}, num_repeats{other.num_repeats} {
+  other.masks = nullptr;
+  other.cells = nullptr;
+  other.size = other.box_size = other.num_boxes = 0;
+  other.num_empty = other.num_repeats = 0;
 }
 
+Sudoku::~Sudoku() { delete[] masks; }
+
 Sudoku &Sudoku::operator=(const Sudoku &rhs) {
   if (this != &rhs) {
-    for (int i = 0; i < size; ++i) {
-      delete[] cells[i];
+    // a moved-from board has no block to copy into
+    if (masks == nullptr || size != rhs.size ||
+        blockWords() != rhs.blockWords()) {
+      delete[] masks;
+      size = rhs.size;
+      initCells();
     }
-    delete[] cells;
+    std::copy(rhs.masks, rhs.masks + blockWords(), masks);
+    num_empty = rhs.num_empty;
+    num_repeats = rhs.num_repeats;
+  }
+  return *this;
+}
+
+Sudoku &Sudoku::operator=(Sudoku &&rhs) noexcept {
+  if (this != &rhs) {
+    delete[] masks;
+    masks = rhs.masks;
+    cells = rhs.cells;
     size = rhs.size;
-    initCells();
-    for (int i = 0; i < size; i++) {
-      for (int j = 0; j < size; j++)
-        cells[i][j] = rhs.cells[i][j];
-    }
+    box_size = rhs.box_size;
+    num_boxes = rhs.num_boxes;
+    num_empty = rhs.num_empty;
+    num_repeats = rhs.num_repeats;
+    rhs.masks = nullptr;
+    rhs.cells = nullptr;
+    rhs.size = rhs.box_size = rhs.num_boxes = 0;
+    rhs.num_empty = rhs.num_repeats = 0;
   }
   return *this;
 }
@@ -94,244 +121,211 @@ Sudoku &Sudoku::operator=(const Sudoku &rhs) {
 bool Sudoku::operator==(Sudoku &rhs) {
   if (size != rhs.size)
     return false;
-  for (int i = 0; i < size; i++)
-    for (int j = 0; j < size; j++)
-      if (cells[i][j] != rhs.cells[i][j])
-        return false;
-  return true;
+  return std::equal(cells, cells + size * size, rhs.cells);
 }
 
 void Sudoku::initCells() {
-  cells = new int *[size] {};
-  for (int i = 0; i < size; i++)
-    cells[i] = new int[size]{};
+  box_size = 1;
+  while ((box_size + 1) * (box_size + 1) <= size)
+    ++box_size;
+  num_boxes = (size + box_size - 1) / box_size;
+  masks = new uint32_t[blockWords()]{};
+  cells = reinterpret_cast<uint8_t *>(masks + 2 * size + num_boxes * num_boxes);
+  num_empty = size * size;
+  num_repeats = 0;
 }
 
-void Sudoku::rtrim(std::string &s, char c) {
-  if (s.empty())
-    return;
-
-  std::string::iterator p{};
-  for (p = s.end(); p != s.begin() && *--p == c;)
-    ;
-
-  if (*p != c)
-    p++;
+size_t Sudoku::blockWords() const {
+  const size_t cell_words{(size_t(size) * size + 3) / 4};
+  return 2 * size + num_boxes * num_boxes + cell_words;
+}
 
-  s.erase(p, s.end());
+uint32_t Sudoku::digitBit(int num) {
+  // boards over 32 x 32 have no masks for the larger digits
+  return num >= 1 && num <= size && num <= 32 ? uint32_t(1) << (num - 1) : 0;
 }
 
-int Sudoku::parseChar(char c) {
-  if (c == '.')
-    return 0;
-  else if (c >= '0' && c <= '9')
-    return c - '0';
-  else if (c >= 'A' && c <= 'P')
-    return c - 'A' + 10;
-  else if (c >= 'a' && c <= 'P')
-    return c - 'a' + 10;
-  else
-    return 0; // TODO: exception when invalid character!!!
+void Sudoku::addDigit(int row, int col, int num) {
+  const uint32_t bit{digitBit(num)};
+  for (uint32_t *mask : {&rowMask(row), &colMask(col), &boxMask(row, col)}) {
+    if (*mask & bit)
+      ++num_repeats;
+    *mask |= bit;
+  }
 }
 
-void Sudoku::fillSudoku(std::string &input) {
-  int i{0}, j{0};
-  for (char &c : input) {
-    int val = parseChar(c);
-    if (val > size || val < 0)
-      val = 0; // TODO: exception when out of range
-    cells[i][j] = val;
-    // next cell
-    j++;
-    if (j >= size) {
-      i++;
-      j = 0;
-      if (i >= size)
-        break;
+void Sudoku::removeDigit(int row, int col, int num) {
+  // the cell is already cleared, a unit keeps the bit when it repeated num
+  const uint32_t bit{digitBit(num)};
+  if (bit == 0)
+    return;
+  const int box_row{row - row % box_size}, box_col{col - col % box_size};
+  bool in_row{false}, in_col{false}, in_box{false};
+  if (num_repeats > 0) {
+    for (int i = 0; i < size; ++i) {
+      in_row = in_row || cells[row * size + i] == num;
+      in_col = in_col || cells[i * size + col] == num;
     }
+    for (int i = box_row; i < std::min(box_row + box_size, size); ++i)
+      for (int j = box_col; j < std::min(box_col + box_size, size); ++j)
+        in_box = in_box || cells[i * size + j] == num;
   }
+  num_repeats -= in_row + in_col + in_box;
+  if (!in_row)
+    rowMask(row) &= ~bit;
+  if (!in_col)
+    colMask(col) &= ~bit;
+  if (!in_box)
+    boxMask(row, col) &= ~bit;
+}
+
+namespace {
+// writes num, which is below 1000, in decimal
+char *writeNumber(char *out, int num) {
+  if (num >= 100)
+    *out++ = static_cast<char>('0' + num / 100);
+  if (num >= 10)
+    *out++ = static_cast<char>('0' + num / 10 % 10);
+  *out++ = static_cast<char>('0' + num % 10);
+  return out;
+}
+} // namespace
+
+size_t Sudoku::maxStringLength(int size) {
+  int box{1};
+  while ((box + 1) * (box + 1) <= size)
+    ++box;
+  if (box * box != size || size > 25)
+    return size_t(size) * (4 * size + 1); // "255 " per cell at most
+  // every line of the drawing has the same length
+  const int square{box * (size > 9 ? 3 : 2) + 1};
+  return size_t(size + box + 1) * (square * box + box + 2);
 }
 
-std::string Sudoku::sudokuToString() {
-  int sqrt_size = static_cast<int>(std::sqrt(size));
+char *Sudoku::writeBoxString(char *out) {
   // 2 character space if single digit, 3 character space if double digit
-  int square_size = sqrt_size * (size > 9 ? 3 : 2) + 1;
-  std::string big_box_string =
-      std::string((square_size * sqrt_size + sqrt_size - 1), '-');
-  std::string small_box_string = std::string(square_size, '-');
-  std::string string = "+" + big_box_string + "+\n";
+  const int width{size > 9 ? 3 : 2};
+  const int square{box_size * width + 1};
+  const int line{square * box_size + box_size + 2};
+  char *const border{out};
+  *out++ = '+';
+  out = std::fill_n(out, line - 3, '-');
+  *out++ = '+';
+  *out++ = '\n';
   for (int row = 0; row < size; row++) {
-    if (row != 0 && row % sqrt_size == 0) {
+    if (row != 0 && row % box_size == 0) {
       // start of next box (section)
-      string += "|";
-      for (int box_n = 0; box_n < sqrt_size; box_n++) {
-        string += small_box_string + "+";
+      *out++ = '|';
+      for (int box_n = 0; box_n < box_size; box_n++) {
+        out = std::fill_n(out, square, '-');
+        *out++ = '+';
       }
-      string.pop_back();
-      string += "|\n";
+      out[-1] = '|';
+      *out++ = '\n';
     }
     for (int col = 0; col < size; col++) {
-      if (col % sqrt_size == 0)
-        string += "| ";
-      int num{cells[row][col]};
-      if (size > 9 && num < 10)
-        string += " "; // add space for single digit
+      if (col % box_size == 0) {
+        *out++ = '|';
+        *out++ = ' ';
+      }
+      int num{cells[row * size + col]};
+      if (width == 3 && num < 10)
+        *out++ = ' '; // add space for single digit
       if (num != 0)
-        string += std::to_string(num) + " ";
+        out = writeNumber(out, num);
       else
-        string += "X ";
+        *out++ = 'X';
+      *out++ = ' ';
     }
-    string += "|\n";
+    *out++ = '|';
+    *out++ = '\n';
   }
-  string += "+" + big_box_string + "+\n";
-  return string;
+  return std::copy(border, border + line, out);
 }
 
-std::string Sudoku::otherToString() {
-  std::string str{};
+char *Sudoku::writeOtherString(char *out) {
   for (int row = 0; row < size; ++row) {
     for (int col = 0; col < size; ++col) {
-      int num{cells[row][col]};
+      int num{cells[row * size + col]};
       if (num != 0)
-        str += std::to_string(num) + " ";
+        out = writeNumber(out, num);
       else
-        str += "X ";
+        *out++ = 'X';
+      *out++ = ' ';
     }
-    str += "\n";
+    *out++ = '\n';
   }
-  return str;
+  return out;
 }
 
-std::string Sudoku::toString() {
+char *Sudoku::writeString(char *out) {
   switch (size) {
   case 4:
   case 9:
   case 16:
   case 25:
-    return sudokuToString();
+    return writeBoxString(out);
   default:
-    return otherToString();
+    return writeOtherString(out);
   }
 }
 
-std::string Sudoku::toSimpleString() {
-  std::string string{""};
-  for (int row = 0; row < size; row++) {
-    for (int col = 0; col < size; col++) {
-      int num{cells[row][col]};
-      if (num == 0)
-        string += ".";
-      else if (num > 9) {
-        char c = 'A' + num - 10;
-        string += c;
-      } else
-        string += std::to_string(num);
-    }
+char *Sudoku::writeSimpleString(char *out) {
+  for (int i = 0; i < size * size; i++) {
+    int num{cells[i]};
+    if (num == 0)
+      *out++ = '.';
+    else if (num > 9)
+      *out++ = static_cast<char>('A' + num - 10);
+    else
+      *out++ = static_cast<char>('0' + num);
   }
-  return string;
+  return out;
 }
 
-bool Sudoku::isIncomplete() {
-  for (int i = 0; i < size; ++i)
-    for (int j = 0; j < size; ++j)
-      if (cells[i][j] == 0)
-        return true;
-  return false;
+std::string Sudoku::toString() {
+  std::string string(maxStringLength(size), '\0');
+  string.resize(static_cast<size_t>(writeString(&string[0]) - &string[0]));
+  return string;
 }
 
-bool Sudoku::isComplete() { return !isIncomplete(); }
-
-bool Sudoku::safeInRow(int row, int num) {
-  for (int i = 0; i < size; ++i)
-    if (cells[row][i] == num)
-      return false;
-  return true;
+std::string Sudoku::toSimpleString() {
+  std::string string(size_t(size) * size, '\0');
+  writeSimpleString(&string[0]);
+  return string;
 }
 
-bool Sudoku::safeInCol(int col, int num) {
-  for (int i = 0; i < size; ++i)
-    if (cells[i][col] == num)
-      return false;
-  return true;
-}
+bool Sudoku::isIncomplete() { return num_empty > 0; }
 
-bool Sudoku::safeInSqr(int startRow, int startCol, int num) {
-  int sqrt_size{static_cast<int>(std::sqrt(size))};
-  int endRow{startRow + sqrt_size}, endCol{startCol + sqrt_size};
-  for (int i = startRow; i < endRow; i++)
-    for (int j = startCol; j < endCol; j++)
-      if (cells[i][j] == num)
-        return false;
-  return true;
-}
+bool Sudoku::isComplete() { return !isIncomplete(); }
 
 bool Sudoku::isSafe(int row, int col, int num) {
   if (!cellIsEmpty(row, col))
     return false;
-  int sqrt_size{static_cast<int>(std::sqrt(size))};
-  return (safeInRow(row, num) && safeInCol(col, num) &&
-          safeInSqr(row - row % sqrt_size, col - col % sqrt_size, num));
-}
-
-bool Sudoku::cellIsEmpty(int row, int col) { return cells[row][col] == 0; }
-
-bool Sudoku::correctInSqr(int startRow, int startCol) {
-  int sqrt_size{static_cast<int>(std::sqrt(size))};
-  int endRow{startRow + sqrt_size}, endCol{startCol + sqrt_size};
-  for (int val = 1; val <= size; val++) {
-    bool num_exist{false};
-    for (int i = startRow; i < endRow; i++)
-      for (int j = startCol; j < endCol; j++) {
-        int check_val{cells[i][j]};
-        if (check_val <= 0 || check_val > size)
-          return false;
-        if (check_val == val)
-          num_exist = true;
-        if (num_exist)
-          break;
-      }
-    if (num_exist)
-      break;
-  }
-  return true;
+  return ((rowMask(row) | colMask(col) | boxMask(row, col)) &
+          digitBit(num)) == 0;
 }
 
-bool Sudoku::isCorrect() {
-  for (int i = 0; i < size; i++) {
-    if (!correctInRow(i) || !correctInCol(i))
-      return false;
-  }
-  int sqrt_size{static_cast<int>(std::sqrt(size))};
-  for (int i = 0; i < size; i += sqrt_size) {
-    for (int j = 0; j < size; j += sqrt_size) {
-      if (!correctInSqr(i, j))
-        return false;
-    }
-  }
-  return true;
+bool Sudoku::cellIsEmpty(int row, int col) {
+  return cells[row * size + col] == 0;
 }
 
-bool Sudoku::correctInRow(int row) {
-  for (int val = 1; val <= size; val++)
-    for (int i = 0; i < size; i++) {
-      int check_val{cells[row][i]};
-      if (check_val <= 0 || check_val > size)
-        return false;
-      if (check_val == val)
-        break;
-    }
-  return true;
+uint32_t Sudoku::candidates(int row, int col) {
+  if (!cellIsEmpty(row, col))
+    return 0;
+  const uint32_t all{size >= 32 ? ~uint32_t(0) : (uint32_t(1) << size) - 1};
+  return all & ~(rowMask(row) | colMask(col) | boxMask(row, col));
 }
 
-bool Sudoku::correctInCol(int col) {
-  for (int val = 1; val <= size; val++)
-    for (int i = 0; i < size; i++) {
-      int check_val{cells[i][col]};
-      if (check_val <= 0 || check_val > size)
-        return false;
-      if (check_val == val)
-        break;
-    }
+bool Sudoku::isCorrect() {
+  // complete, and every unit holds every digit
+  if (num_empty > 0 || size > 32)
+    return false;
+  const uint32_t all{size == 32 ? ~uint32_t(0) : (uint32_t(1) << size) - 1};
+  const int num_masks{box_size * box_size == size ? 3 * size : 2 * size};
+  for (int i = 0; i < num_masks; ++i)
+    if (masks[i] != all)
+      return false;
   return true;
 }
 
@@ -341,5 +335,19 @@ std::ostream &operator<<(std::ostream &os, Sudoku &sdk) {
 }
 
 int Sudoku::getSize() { return size; }
-void Sudoku::setCell(int row, int col, int val) { cells[row][col] = val; }
-int Sudoku::getCell(int row, int col) { return cells[row][col]; }
+void Sudoku::setCell(int row, int col, int val) {
+  uint8_t &cell = cells[row * size + col];
+  const uint8_t old{cell};
+  cell = static_cast<uint8_t>(val);
+  if (old == cell)
+    return;
+  if (old != 0) {
+    ++num_empty;
+    removeDigit(row, col, old);
+  }
+  if (cell != 0) {
+    --num_empty;
+    addDigit(row, col, cell);
+  }
+}
+int Sudoku::getCell(int row, int col) { return cells[row * size + col]; }
@@ -30,14 +30,240 @@
  */
 
 #include "SudokuSolver.hpp"
+#include "BitboardSolver.hpp"
+#include "Board.hpp"
+#include "Canonical.hpp"
 #include "DLX.hpp"
+#include "Propagator.hpp"
+#include "SolutionCache.hpp"
+#include "Solver.hpp"
 #include "Sudoku.hpp"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
 #include <vector>
 
-SudokuSolver::SudokuSolver(Sudoku puzzle) : m_puzzle(puzzle) {
+namespace {
+// Exact cover matrix of an empty grid with variant regions. It only depends
+// on the size and the regions, so each thread keeps the ones it has built
+// and puzzles just select their givens.
+// Solutions are decoded from the row ids, see Solver<N>::rowId(), so the
+// rows are not kept once the DLX is built.
+struct Skeleton {
+  Skeleton(int size, const SudokuSolver::Variant &variant,
+           const std::vector<std::vector<int>> &rows, int num_secondary)
+      : size(size), regions(variant.regions),
+        dlx((4 * size + static_cast<int>(regions.size())) * size, rows,
+            num_secondary) {}
+  int size;
+  std::vector<std::vector<std::pair<int, int>>> regions;
+  DLX dlx;
+};
+
+thread_local std::vector<std::unique_ptr<Skeleton>> skeleton_pool{};
+
+// search nodes between checks of the deadline and the cancel flag
+const uint64_t slice_nodes{4096};
+
+// borrows a skeleton from this thread's pool, and resets and returns it at
+// the end of the search
+class SkeletonLease {
+public:
+  template <typename Build>
+  SkeletonLease(int size, const SudokuSolver::Variant &variant,
+                int num_secondary, Build build) {
+    for (auto it = skeleton_pool.begin(); it != skeleton_pool.end(); ++it) {
+      if ((*it)->size == size && (*it)->regions == variant.regions) {
+        skeleton = std::move(*it);
+        skeleton_pool.erase(it);
+        return;
+      }
+    }
+    skeleton.reset(new Skeleton{size, variant, build(), num_secondary});
+  }
+  ~SkeletonLease() {
+    skeleton->dlx.reset();
+    skeleton_pool.push_back(std::move(skeleton));
+  }
+  Skeleton *operator->() { return skeleton.get(); }
+
+private:
+  std::unique_ptr<Skeleton> skeleton{};
+};
+
+// Counts a solution, and stores it and passes it to on_solution as the
+// options ask. make() builds it, only when it is needed. Returns false if
+// the search should stop.
+template <typename Make>
+bool recordSolution(SudokuSolver::SSResult &result,
+                    const SudokuSolver::SSOptions &options, Make make) {
+  ++result.number_of_solution;
+  const bool store{result.solutions.size() < options.max_stored};
+  if (!store && !options.on_solution)
+    return true; // only counting
+  Sudoku solution{make()};
+  bool next{true};
+  if (options.on_solution)
+    next = options.on_solution(solution);
+  if (store)
+    result.solutions.push_back(std::move(solution));
+  return next;
+}
+
+// why the search has to stop, safe to call from the parallel search. race
+// is set once another search of a portfolio has finished.
+SudokuSolver::SSResult::Status
+stopReason(const SudokuSolver::SSOptions &options, uint64_t nodes,
+           const std::atomic<bool> *race) {
+  typedef SudokuSolver::SSResult::Status Status;
+  if (options.max_nodes != 0 && nodes >= options.max_nodes)
+    return Status::OutOfNodes;
+  if ((options.cancel && options.cancel->load()) || (race && race->load()))
+    return Status::Cancelled;
+  if (std::chrono::steady_clock::now() >= options.deadline)
+    return Status::OutOfTime;
+  return Status::Complete;
+}
+
+// Runs the exact cover search as the options ask, decode() turns the
+// current solution of dlx into a Sudoku.
+template <typename Decode>
+void searchCover(DLX &dlx, const SudokuSolver::SSOptions &options,
+                 const std::atomic<bool> *race,
+                 SudokuSolver::SSResult &result, Decode decode) {
+  // returns false if the search should stop
+  auto record = [&]() { return recordSolution(result, options, decode); };
+  typedef SudokuSolver::SSResult::Status Status;
+  auto budget = [&options, race](uint64_t nodes) {
+    return stopReason(options, nodes, race);
+  };
+  if (options.threads != 1 && options.max_solutions == 1) {
+    auto stop = [&budget](uint64_t nodes) {
+      return budget(nodes) != Status::Complete;
+    };
+    DLX::Status status{dlx.solve(options.threads, stop)};
+    if (status == DLX::Status::Solved)
+      record();
+    else if (status == DLX::Status::Suspended)
+      result.status = budget(dlx.getNodeCount());
+  } else {
+    // the budget is checked whenever the search crosses a slice boundary,
+    // however many solutions it finds in between
+    uint64_t slice_end{slice_nodes};
+    while (result.number_of_solution != options.max_solutions ||
+           options.max_solutions == 0) {
+      if (options.max_nodes != 0)
+        slice_end = std::min(slice_end, options.max_nodes);
+      DLX::Status status{DLX::Status::Suspended};
+      if (dlx.getNodeCount() < slice_end)
+        status = dlx.search(slice_end - dlx.getNodeCount());
+      if (status == DLX::Status::Suspended) {
+        result.status = budget(dlx.getNodeCount());
+        if (result.status != Status::Complete)
+          break;
+        slice_end += slice_nodes;
+      } else if (status != DLX::Status::Solved || !record())
+        break;
+    }
+  }
+  result.statistics = dlx.getStatistics();
+}
+
+// A random transform, see Transform. Bands and stacks are shuffled, and
+// the lines within each of them, so boxes stay boxes.
+Transform shuffledTransform(int size, std::mt19937_64 &rng) {
+  // by hand, std::shuffle may differ between standard libraries
+  auto shuffle = [&rng](uint8_t *items, int count) {
+    for (int i = count; i > 1; --i)
+      std::swap(items[i - 1], items[rng() % i]);
+  };
+  Transform transform{Transform::identity(size)};
+  const int box{static_cast<int>(std::sqrt(size))};
+  transform.transposed = rng() % 2 != 0;
+  for (auto *lines : {&transform.rows, &transform.cols}) {
+    uint8_t blocks[max_transform_size];
+    for (int b = 0; b < box; ++b)
+      blocks[b] = static_cast<uint8_t>(b);
+    shuffle(blocks, box);
+    for (int b = 0; b < box; ++b) {
+      for (int i = 0; i < box; ++i)
+        (*lines)[b * box + i] = static_cast<uint8_t>(blocks[b] * box + i);
+      shuffle(lines->data() + b * box, box);
+    }
+  }
+  shuffle(transform.digits.data() + 1, size);
+  return transform;
+}
+
+// moves the cells of the regions to where transform puts them
+SudokuSolver::Variant transformVariant(const SudokuSolver::Variant &variant,
+                                       const Transform &transform) {
+  int row_of[max_transform_size], col_of[max_transform_size];
+  for (int i = 0; i < transform.size; ++i) {
+    row_of[transform.rows[i]] = i;
+    col_of[transform.cols[i]] = i;
+  }
+  SudokuSolver::Variant moved{variant};
+  for (auto &region : moved.regions) {
+    for (auto &cell : region) {
+      // a transposed cell (row, col) is read from (col, row)
+      if (transform.transposed)
+        cell = std::make_pair(row_of[cell.second], col_of[cell.first]);
+      else
+        cell = std::make_pair(row_of[cell.first], col_of[cell.second]);
+    }
+  }
+  return moved;
+}
+
+// hash of everything that decides the result of a search
+SolutionCache::Key cacheKey(Sudoku &puzzle,
+                            const SudokuSolver::Variant &variant,
+                            const SudokuSolver::SSOptions &options) {
+  SolutionCache::Hasher hasher{};
+  const int size{puzzle.getSize()};
+  hasher.add(static_cast<uint64_t>(size));
+  // eight cells to a word
+  uint64_t word{0};
+  int packed{0};
+  for (int row = 0; row < size; ++row) {
+    for (int col = 0; col < size; ++col) {
+      word = word << 8 | static_cast<uint64_t>(puzzle.getCell(row, col));
+      if (++packed % 8 == 0) {
+        hasher.add(word);
+        word = 0;
+      }
+    }
+  }
+  hasher.add(word);
+  hasher.add(variant.regions.size());
+  for (auto &region : variant.regions) {
+    hasher.add(region.size());
+    for (auto &cell : region)
+      hasher.add(static_cast<uint64_t>(cell.first) << 32 |
+                 static_cast<uint64_t>(cell.second));
+  }
+  hasher.add(options.max_solutions);
+  hasher.add(options.max_stored);
+  // the options that change how the search runs, and so its statistics
+  hasher.add(static_cast<uint64_t>(options.bitboard) << 1 |
+             static_cast<uint64_t>(options.propagate));
+  hasher.add(options.threads);
+  hasher.add(options.portfolio);
+  hasher.add(options.portfolio_seed);
+  return hasher.key();
+}
+} // namespace
+
+SudokuSolver::SudokuSolver(Sudoku puzzle) : m_puzzle(std::move(puzzle)) {
+  m_size = m_puzzle.getSize();
+}
+
+SudokuSolver::SudokuSolver(Sudoku puzzle, Variant variant)
+    : m_puzzle(std::move(puzzle)), m_variant(std::move(variant)) {
   m_size = m_puzzle.getSize();
 }
 
@@ -45,89 +271,280 @@ SudokuSolver::SudokuSolver(int **const arr, int size) : m_puzzle(arr, size) {
   m_size = size;
 }
 
-SudokuSolver::SSResult SudokuSolver::search() {
+SudokuSolver::Variant SudokuSolver::Variant::sudokuX(int size) {
+  Variant variant{};
+  variant.regions.resize(2);
+  for (int i = 0; i < size; ++i) {
+    variant.regions[0].emplace_back(i, i);
+    variant.regions[1].emplace_back(i, size - 1 - i);
+  }
+  return variant;
+}
+
+SudokuSolver::Variant SudokuSolver::Variant::windoku(int size) {
+  // boxes one cell in from the regular ones, e.g. rows and columns 1-3 and
+  // 5-7 on a 9x9 grid
+  Variant variant{};
+  const int sqrt_size{static_cast<int>(std::sqrt(size))};
+  for (int row = 1; row + sqrt_size <= size; row += sqrt_size + 1) {
+    for (int col = 1; col + sqrt_size <= size; col += sqrt_size + 1) {
+      std::vector<std::pair<int, int>> region{};
+      for (int i = row; i < row + sqrt_size; ++i)
+        for (int j = col; j < col + sqrt_size; ++j)
+          region.emplace_back(i, j);
+      variant.regions.push_back(region);
+    }
+  }
+  return variant;
+}
+
+SudokuSolver::SSResult SudokuSolver::search() { return search(SSOptions{}); }
+
+struct SudokuSolver::BoardSearch {
+  SudokuSolver &solver;
+  const SSOptions &options;
+  template <int N> SSResult visit() { return solver.searchBoard<N>(options); }
+};
+
+SudokuSolver::SSResult SudokuSolver::search(const SSOptions &options) {
+  // only square sizes up to 25 x 25 have boxes to solve
+  BoardSearch board_search{*this, options};
+  auto run = [&]() {
+    if (options.portfolio > 1 && !options.on_solution)
+      return searchPortfolio(options);
+    if (!hasBoardSize(m_size))
+      return searchAnySize(options);
+    return dispatchBoardSize(m_size, board_search, SSResult{});
+  };
+  if (options.cache == nullptr || options.on_solution)
+    return run();
+
+  const SolutionCache::Key key{cacheKey(m_puzzle, m_variant, options)};
+  SSResult result{};
+  if (options.cache->find(key, result))
+    return result;
+  result = run();
+  // a search cut short may end differently next time
+  if (result.status == SSResult::Status::Complete)
+    options.cache->insert(key, result);
+  return result;
+}
+
+template <int N>
+SudokuSolver::SSResult SudokuSolver::searchBoard(const SSOptions &options) {
+  if (N == 9 && options.bitboard && m_variant.regions.empty())
+    return searchBitboard(options);
   SSResult result{};
-  std::vector<std::vector<int>> matrix = toExactCover();
-  DLX dlx{matrix};
-  if (dlx.solve()) {
-    std::vector<int> solution = dlx.getSolution();
-    ++result.number_of_solution;
-    result.solutions.push_back(toSudoku(matrix, solution));
+  Board<N> puzzle{m_puzzle};
+  Propagator<N> propagator{puzzle, m_variant.regions};
+  if (options.propagate) {
+    switch (propagator.run()) {
+    case Propagator<N>::Outcome::Contradiction:
+      return result;
+    case Propagator<N>::Outcome::Solved:
+      // every cell is forced, nothing else can be a solution
+      recordSolution(result, options,
+                     [&]() { return propagator.getBoard().toSudoku(); });
+      return result;
+    case Propagator<N>::Outcome::Stuck:
+      puzzle = propagator.getBoard();
+      break;
+    }
+  }
+
+  const int num_secondary{
+      (static_cast<int>(m_variant.regions.size()) - numPrimaryRegions()) * N};
+  // A classic grid gets a matrix of just the candidates its givens leave,
+  // which is quicker to build than a skeleton is to reset, and smaller to
+  // search. Variants reuse the skeleton of their regions.
+  std::unique_ptr<DLX> pruned{};
+  std::unique_ptr<SkeletonLease> skeleton{};
+  auto build = [this]() { return toExactCover(Solver<N>::exactCover()); };
+  if (m_variant.regions.empty())
+    pruned.reset(
+        new DLX{Solver<N>::num_columns, Solver<N>::exactCover(puzzle)});
+  else
+    skeleton.reset(new SkeletonLease{N, m_variant, num_secondary, build});
+  DLX &dlx = pruned ? *pruned : (*skeleton)->dlx;
+  if (!Solver<N>::selectGivens(dlx, puzzle))
+    return result; // givens break the rules, no solution
+  if (options.propagate) {
+    // rows clashing with the filled cells are out already, remove() skips
+    // them
+    for (int i = 0; i < N; ++i)
+      for (int j = 0; j < N; ++j)
+        if (puzzle.cellIsEmpty(i, j))
+          for (int num = 1; num <= N; ++num)
+            if ((propagator.candidates(i, j) >> (num - 1) & 1) == 0)
+              dlx.remove(Solver<N>::rowId(i, j, num));
   }
+  searchCover(dlx, options, m_race, result, [&]() {
+    Board<N> board{puzzle};
+    Solver<N>::apply(dlx.getSolution(), board);
+    return board.toSudoku();
+  });
   return result;
 }
 
-std::vector<std::vector<int>> SudokuSolver::toExactCover() {
-  std::vector<std::vector<int>> matrix{};
+SudokuSolver::SSResult SudokuSolver::searchAnySize(const SSOptions &options) {
+  SSResult result{};
+  const int box{static_cast<int>(std::sqrt(m_size))};
+  if (m_size < 1 || box * box != m_size) {
+    result.status = SSResult::Status::BadSize;
+    return result;
+  }
+  // the classic rows as Solver<N>::exactCover() lays them out
+  std::vector<std::vector<int>> rows(m_size * m_size * m_size);
+  const int cells{m_size * m_size};
   for (int i = 0; i < m_size; ++i) {
     for (int j = 0; j < m_size; ++j) {
-      int num = m_puzzle.getCell(i, j);
-      if (num == 0) {
-        for (int p_num = 1; p_num <= m_size; ++p_num) {
-          std::vector<int> row = toExactCoverRow(i, j, p_num);
-          matrix.push_back(row);
-        }
-      } else {
-        std::vector<int> row = toExactCoverRow(i, j, num);
-        matrix.push_back(row);
-      }
+      const int box_index{i / box * box + j / box};
+      for (int num = 0; num < m_size; ++num)
+        rows[(i * m_size + j) * m_size + num] = {
+            i * m_size + j, cells + i * m_size + num,
+            2 * cells + j * m_size + num, 3 * cells + box_index * m_size + num};
+    }
+  }
+  const int num_secondary{
+      (static_cast<int>(m_variant.regions.size()) - numPrimaryRegions()) *
+      m_size};
+  DLX dlx{(4 * m_size + static_cast<int>(m_variant.regions.size())) * m_size,
+          toExactCover(std::move(rows)), num_secondary};
+  for (int i = 0; i < m_size; ++i) {
+    for (int j = 0; j < m_size; ++j) {
+      const int num{m_puzzle.getCell(i, j)};
+      if (num != 0 &&
+          (num > m_size || !dlx.select((i * m_size + j) * m_size + num - 1)))
+        return result; // givens break the rules, no solution
     }
   }
+  searchCover(dlx, options, m_race, result, [&]() {
+    Sudoku solution{m_puzzle};
+    for (int id : dlx.getSolution())
+      solution.setCell(id / cells, id / m_size % m_size, id % m_size + 1);
+    return solution;
+  });
+  return result;
+}
+
+SudokuSolver::SSResult SudokuSolver::searchBitboard(const SSOptions &options) {
+  SSResult result{};
+  BitboardSolver solver{Board<9>{m_puzzle}};
+  auto sink = [&](const Board<9> &board) {
+    return recordSolution(result, options,
+                          [&]() { return board.toSudoku(); }) &&
+           result.number_of_solution != options.max_solutions;
+  };
+  typedef SSResult::Status Status;
+  auto stop = [this, &options](uint64_t nodes) {
+    return stopReason(options, nodes, m_race) != Status::Complete;
+  };
+  switch (solver.search(sink, options.max_nodes, stop, slice_nodes)) {
+  case BitboardSolver::Status::Complete:
+    break;
+  case BitboardSolver::Status::OutOfNodes:
+    result.status = Status::OutOfNodes;
+    break;
+  case BitboardSolver::Status::Stopped:
+    result.status = stopReason(options, solver.getNodeCount(), m_race);
+    break;
+  }
+  result.statistics.nodes = solver.getNodeCount();
+  return result;
+}
+
+SudokuSolver::SSResult SudokuSolver::searchPortfolio(const SSOptions &options) {
+  const int box{static_cast<int>(std::sqrt(m_size))};
+  if (box * box != m_size || m_size > max_transform_size) {
+    // the caller has looked in the cache already
+    SSOptions single{options};
+    single.portfolio = 1;
+    single.cache = nullptr;
+    return search(single);
+  }
+  SSOptions member_options{options};
+  member_options.portfolio = 1;
+  member_options.cache = nullptr;
+  std::atomic<bool> finished{false};
+  std::atomic<int> winner{-1};
+  std::mt19937_64 rng{options.portfolio_seed};
+  const int members{static_cast<int>(options.portfolio)};
+  std::vector<Transform> transforms{Transform::identity(m_size)};
+  std::vector<SudokuSolver> solvers{};
+  solvers.reserve(members);
+  solvers.push_back(*this);
+  for (int i = 1; i < members; ++i) {
+    transforms.push_back(shuffledTransform(m_size, rng));
+    solvers.emplace_back(transforms[i].apply(m_puzzle),
+                         transformVariant(m_variant, transforms[i]));
+  }
+  std::vector<SSResult> results(members);
+  auto race = [&](int i) {
+    solvers[i].m_race = &finished;
+    results[i] = solvers[i].search(member_options);
+    // the first to complete wins and stops the others
+    int none{-1};
+    if (results[i].status == SSResult::Status::Complete &&
+        winner.compare_exchange_strong(none, i))
+      finished = true;
+  };
+  std::vector<std::thread> threads{};
+  for (int i = 1; i < members; ++i)
+    threads.emplace_back(race, i);
+  race(0);
+  for (auto &thread : threads)
+    thread.join();
+
+  // without a winner every search hit a limit, report the unshuffled one
+  const int won{winner.load()};
+  if (won <= 0)
+    return std::move(results[0]);
+  SSResult &result = results[won];
+  for (auto &solution : result.solutions)
+    solution = transforms[won].revert(solution);
+  return std::move(result);
+}
+
+unsigned SudokuSolver::countSolutions(unsigned limit) {
+  SSOptions options{};
+  options.max_solutions = limit;
+  options.max_stored = 0;
+  return search(options).number_of_solution;
+}
+
+bool SudokuSolver::hasUniqueSolution() { return countSolutions(2) == 1; }
+
+std::vector<std::vector<int>>
+SudokuSolver::toExactCover(std::vector<std::vector<int>> matrix) {
+  // Variant regions get m_size columns each after the four classic
+  // constraints, full regions first since the partial ones are secondary.
+  const int size{m_size};
+  std::vector<std::vector<int>> cell_regions(size * size);
+  int primary{0}, secondary{numPrimaryRegions()};
+  for (auto &region : m_variant.regions) {
+    const bool full{static_cast<int>(region.size()) == size};
+    const int base{4 * size * size + (full ? primary++ : secondary++) * size};
+    for (auto &cell : region) {
+      assert(cell.first >= 0 && cell.first < size);
+      assert(cell.second >= 0 && cell.second < size);
+      cell_regions[cell.first * size + cell.second].push_back(base);
+    }
+  }
+  for (auto &bases : cell_regions)
+    std::sort(bases.begin(), bases.end());
+
+  // rows are in row id order, see Solver<N>::rowId()
+  for (int cell = 0; cell < size * size; ++cell)
+    for (int base : cell_regions[cell])
+      for (int num = 0; num < size; ++num)
+        matrix[cell * size + num].push_back(base + num);
   return matrix;
 }
 
-std::vector<int> SudokuSolver::toExactCoverRow(int row, int col, int num) {
-  std::vector<int> ec_row{};
-  int sqrt_size{static_cast<int>(std::sqrt(m_size))};
-  int sqr_size{static_cast<int>(std::pow(m_size, 2))};
-  ec_row.resize(static_cast<int>(sqr_size * 4));
-  int pos{row * m_size + col};
-  int cond_row{row * m_size + (num - 1) + sqr_size};
-  int cond_col{col * m_size + (num - 1) + 2 * sqr_size};
-  int cond_region{(row / sqrt_size * sqrt_size + col / sqrt_size) * m_size +
-                  (num - 1) + 3 * sqr_size};
-  ec_row[pos] = 1;
-  ec_row[cond_row] = 1;
-  ec_row[cond_col] = 1;
-  ec_row[cond_region] = 1;
-  return ec_row;
-}
-
-Sudoku SudokuSolver::toSudoku(std::vector<std::vector<int>> matrix,
-                              std::vector<int> solution) {
-  Sudoku sudoku{m_puzzle};
-  for (auto row : solution)
-    rowToSudoku(matrix[row], &sudoku);
-  return sudoku;
-}
-
-void SudokuSolver::rowToSudoku(std::vector<int> sol, Sudoku *sudoku) {
-  int sqr_size = pow(m_size, 2);
-  // find row
-  auto it = std::find(sol.begin(), sol.begin() + (sqr_size - 1), 1);
-  assert(it != sol.end());
-  int pos = std::distance(sol.begin(), it);
-  int col{pos % m_size};
-  int row{(pos - col) / m_size};
-  it = std::find(sol.begin() + sqr_size, sol.begin() + (2 * sqr_size - 1), 1);
-  assert(it != sol.end());
-  int cond_row = std::distance(sol.begin(), it);
-  int num{cond_row % m_size + 1};
-  sudoku->setCell(row, col, num);
-}
-
-std::string SudokuSolver::getNumFromEC(std::vector<int> sol) {
-  int sqr_size = pow(m_size, 2);
-  // find row
-  auto it = std::find(sol.begin(), sol.begin() + (sqr_size - 1), 1);
-  assert(it != sol.end());
-  int pos = std::distance(sol.begin(), it);
-  int col{pos % m_size};
-  int row{(pos - col) / m_size};
-  it = std::find(sol.begin() + sqr_size, sol.begin() + (2 * sqr_size - 1), 1);
-  assert(it != sol.end());
-  int cond_row = std::distance(sol.begin(), it);
-  int num{cond_row % m_size + 1};
-  return "(" + std::to_string(num) + ", " + std::to_string(row) + ", " +
-         std::to_string(col) + ")";
+int SudokuSolver::numPrimaryRegions() {
+  int primary{0};
+  for (auto &region : m_variant.regions)
+    if (static_cast<int>(region.size()) == m_size)
+      ++primary;
+  return primary;
 }
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2015 Jia Heng Eik
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Verifier.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jiaheng
+ */
+
+#include "Verifier.hpp"
+#include "Board.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERIFIER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Bitwise operations on as many lanes as the target has, a plain 64 bit
+// word without SSE2. Pointers to load() and store() are 32 byte aligned.
+#if defined(__AVX2__)
+typedef __m256i Vec;
+inline Vec load(const void *p) {
+  return _mm256_load_si256(static_cast<const __m256i *>(p));
+}
+inline void store(void *p, Vec v) {
+  _mm256_store_si256(static_cast<__m256i *>(p), v);
+}
+inline Vec vecOr(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline Vec vecAnd(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+#elif defined(VERIFIER_SSE2)
+typedef __m128i Vec;
+inline Vec load(const void *p) {
+  return _mm_load_si128(static_cast<const __m128i *>(p));
+}
+inline void store(void *p, Vec v) {
+  _mm_store_si128(static_cast<__m128i *>(p), v);
+}
+inline Vec vecOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec vecAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+#else
+typedef uint64_t Vec;
+inline Vec load(const void *p) {
+  Vec v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+inline void store(void *p, Vec v) { std::memcpy(p, &v, sizeof(v)); }
+inline Vec vecOr(Vec a, Vec b) { return a | b; }
+inline Vec vecAnd(Vec a, Vec b) { return a & b; }
+#endif
+
+// grids checked together, one lane each
+const size_t block_grids{16};
+
+// digit bits of one cell, wide enough for N digits
+template <int N> struct Lane { typedef uint16_t type; };
+template <> struct Lane<25> { typedef uint32_t type; };
+
+// cells of every unit and the bit of every byte value, built once per size
+template <int N> struct Tables {
+  typedef typename Lane<N>::type lane_type;
+  static const lane_type all = lane_type((uint32_t(1) << N) - 1);
+
+  static const Tables &get() {
+    static const Tables tables{};
+    return tables;
+  }
+
+  // rows, then columns, then boxes
+  std::array<std::array<uint16_t, N>, 3 * N> units;
+  // 0 for empty cells and values over N, so their units come up short
+  std::array<lane_type, 256> bit;
+
+private:
+  Tables() {
+    const int box{Board<N>::box};
+    for (int u = 0; u < N; ++u) {
+      for (int i = 0; i < N; ++i) {
+        units[u][i] = static_cast<uint16_t>(u * N + i);
+        units[N + u][i] = static_cast<uint16_t>(i * N + u);
+        const int row{u / box * box + i / box}, col{u % box * box + i % box};
+        units[2 * N + u][i] = static_cast<uint16_t>(row * N + col);
+      }
+    }
+    bit.fill(0);
+    for (int num = 1; num <= N; ++num)
+      bit[num] = lane_type(uint32_t(1) << (num - 1));
+  }
+};
+
+template <int N> bool verifyOne(const uint8_t *grid) {
+  typedef Tables<N> T;
+  const T &tables = T::get();
+  typename T::lane_type every{T::all};
+  for (auto &unit : tables.units) {
+    typename T::lane_type seen{0};
+    for (uint16_t cell : unit)
+      seen |= tables.bit[grid[cell]];
+    every &= seen;
+  }
+  return every == T::all;
+}
+
+// Checks up to block_grids grids. Grid g is spread over lane g of one row
+// per cell, and a grid is correct when the OR of every unit has all bits,
+// so ANDing those ORs over all units keeps every bit.
+template <int N>
+void verifyBlock(const uint8_t *grids, size_t count, uint8_t *ok) {
+  typedef Tables<N> T;
+  typedef typename T::lane_type lane_type;
+  const T &tables = T::get();
+  alignas(32) lane_type bits[N * N][block_grids];
+  for (size_t g = 0; g < count; ++g) {
+    const uint8_t *grid{grids + g * N * N};
+    for (int cell = 0; cell < N * N; ++cell)
+      bits[cell][g] = tables.bit[grid[cell]];
+  }
+  for (size_t g = count; g < block_grids; ++g)
+    for (int cell = 0; cell < N * N; ++cell)
+      bits[cell][g] = T::all;
+
+  alignas(32) lane_type every[block_grids];
+  const size_t lanes_per_vec{sizeof(Vec) / sizeof(lane_type)};
+  for (size_t lane = 0; lane < block_grids; lane += lanes_per_vec) {
+    Vec all_units{};
+    for (size_t u = 0; u < tables.units.size(); ++u) {
+      const std::array<uint16_t, N> &unit = tables.units[u];
+      Vec seen{load(&bits[unit[0]][lane])};
+      for (int i = 1; i < N; ++i)
+        seen = vecOr(seen, load(&bits[unit[i]][lane]));
+      all_units = u == 0 ? seen : vecAnd(all_units, seen);
+    }
+    store(&every[lane], all_units);
+  }
+  for (size_t g = 0; g < count; ++g)
+    ok[g] = every[g] == T::all;
+}
+
+struct VerifyOne {
+  const uint8_t *grid;
+  template <int N> bool visit() { return verifyOne<N>(grid); }
+};
+
+struct VerifyMany {
+  const uint8_t *grids;
+  size_t count;
+  uint8_t *ok;
+  template <int N> bool visit() {
+    for (size_t first = 0; first < count; first += block_grids)
+      verifyBlock<N>(grids + first * N * N,
+                     std::min(block_grids, count - first), ok + first);
+    return true;
+  }
+};
+} // namespace
+
+bool verifyGrid(int size, const uint8_t *grid) {
+  VerifyOne verify{grid};
+  return dispatchBoardSize(size, verify, false);
+}
+
+size_t verifyGrids(int size, const uint8_t *grids, size_t count,
+                   uint8_t *ok) {
+  VerifyMany verify{grids, count, ok};
+  if (!dispatchBoardSize(size, verify, false))
+    std::fill(ok, ok + count, 0); // unsupported sizes are never correct
+  return static_cast<size_t>(std::count(ok, ok + count, 1));
+}
@@ -27,7 +27,6 @@
 #include <iostream>
 #include <vector>
 
-#include "DLNode.hpp"
 #include "DLX.hpp"
 
 namespace {
@@ -115,6 +114,111 @@ TEST(DlxTest, SingleSolutionTest) {
       << "Solution does not contain 4";
 }
 
+TEST(DlxTest, SparseSingleSolutionTest) {
+  // same problem as problemMatrix(), given as column indices per row
+  std::vector<std::vector<int>> rows{{2, 4, 5}, {0, 3, 6}, {1, 2, 5},
+                                     {0, 3},    {1, 6},    {3, 4, 6}};
+  DLX dlx{7, rows};
+  EXPECT_TRUE(dlx.solve());
+  auto result = dlx.getSolution();
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<int>({0, 3, 4}), result);
+}
+
+TEST(DlxTest, SparseEmptyRowTest) {
+  std::vector<std::vector<int>> rows{{}, {0}, {1, 2}, {}};
+  DLX dlx{3, rows};
+  EXPECT_TRUE(dlx.solve());
+  auto result = dlx.getSolution();
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<int>({1, 2}), result);
+}
+
+TEST(DlxTest, SecondaryColumnTest) {
+  std::vector<std::vector<int>> rows{{0, 2}, {1, 2}, {0}, {1}};
+  // column 2 covered exactly once: rows {0, 3} or {1, 2}
+  DLX primary{3, rows};
+  EXPECT_EQ(2, primary.count());
+  // column 2 covered at most once: rows {2, 3} are a solution as well
+  DLX secondary{3, rows, 1};
+  EXPECT_EQ(3, secondary.count());
+  // a row with secondary columns only is never needed
+  DLX only_secondary{2, {{0}, {1}, {0, 1}}, 1};
+  EXPECT_EQ(2, only_secondary.count());
+}
+
+TEST(DlxTest, SuspendResumeTest) {
+  auto matrix = problemMatrix();
+  DLX dlx{matrix};
+  int suspended{0};
+  DLX::Status status{};
+  while ((status = dlx.search(1)) == DLX::Status::Suspended)
+    ++suspended;
+  EXPECT_EQ(DLX::Status::Solved, status);
+  EXPECT_GT(suspended, 0) << "search should have been suspended";
+  auto result = dlx.getSolution();
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<int>({0, 3, 4}), result);
+  // the solution is unique, resuming exhausts the search
+  EXPECT_EQ(DLX::Status::Unsolvable, dlx.search());
+  EXPECT_EQ(DLX::Status::Unsolvable, dlx.search());
+}
+
+TEST(DlxTest, SelectTest) {
+  DLX dlx{problemMatrix()};
+  EXPECT_FALSE(dlx.select(1) && dlx.select(3)) << "rows 1 and 3 clash";
+  dlx.reset();
+  ASSERT_TRUE(dlx.select(3));
+  EXPECT_TRUE(dlx.solve());
+  auto result = dlx.getSolution();
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<int>({0, 4}), result);
+  // no solution contains row 1
+  dlx.unselect();
+  ASSERT_TRUE(dlx.select(1));
+  EXPECT_FALSE(dlx.solve());
+  dlx.reset();
+  EXPECT_EQ(1, dlx.count());
+}
+
+TEST(DlxTest, RemoveTest) {
+  DLX dlx{multiSolutionMatrix()};
+  ASSERT_TRUE(dlx.remove(5));
+  EXPECT_EQ(24, dlx.count());
+  ASSERT_TRUE(dlx.remove(4));
+  EXPECT_FALSE(dlx.remove(4)) << "already removed";
+  EXPECT_EQ(16, dlx.count());
+  ASSERT_TRUE(dlx.select(9));
+  EXPECT_FALSE(dlx.remove(10)) << "clashes with row 9";
+  EXPECT_FALSE(dlx.select(4)) << "removed rows cannot be selected";
+  EXPECT_EQ(8, dlx.count());
+  dlx.unselect();
+  dlx.unselect();
+  EXPECT_EQ(24, dlx.count());
+  dlx.reset();
+  EXPECT_EQ(36, dlx.count());
+}
+
+TEST(DlxTest, StatisticsTest) {
+  DLX dlx{multiSolutionMatrix()};
+  EXPECT_EQ(36, dlx.count());
+  auto stats = dlx.getStatistics();
+  EXPECT_EQ(dlx.getNodeCount(), stats.nodes);
+  EXPECT_GT(stats.nodes, 36);
+  if (DLX::statistics_enabled) {
+    // the search is exhausted, so everything covered has been uncovered
+    EXPECT_EQ(stats.covers, stats.uncovers);
+    EXPECT_GT(stats.backtracks, 0);
+    EXPECT_EQ(6, stats.max_depth);
+    uint64_t branched{0};
+    for (auto nodes : stats.branching)
+      branched += nodes;
+    EXPECT_EQ(stats.nodes - 36, branched) << "solved nodes do not branch";
+  }
+  dlx.reset();
+  EXPECT_EQ(0, dlx.getStatistics().nodes);
+}
+
 TEST(DlxTest, MultiSolutionTest) {
   auto matrix = multiSolutionMatrix();
   DLX dlx{matrix};
@@ -134,6 +238,50 @@ TEST(DlxTest, MultiSolutionTest) {
   }
 }
 
+TEST(DlxTest, CountSolutionTest) {
+  DLX dlx{multiSolutionMatrix()};
+  EXPECT_EQ(36, dlx.count());
+  EXPECT_EQ(0, dlx.count()) << "search should be exhausted";
+  DLX limited{multiSolutionMatrix()};
+  EXPECT_EQ(2, limited.count(2));
+  EXPECT_EQ(34, limited.count()) << "count should resume after the limit";
+  DLX single{problemMatrix()};
+  EXPECT_EQ(1, single.count(2));
+}
+
+TEST(DlxTest, EnumerateTest) {
+  auto matrix = multiSolutionMatrix();
+  DLX dlx{matrix};
+  std::vector<std::vector<int>> solutions{};
+  auto passed = dlx.enumerate([&](const std::vector<int> &rows) {
+    solutions.push_back(rows);
+    return solutions.size() < 5;
+  });
+  EXPECT_EQ(5, passed);
+  ASSERT_EQ(5, solutions.size());
+  for (auto &rows : solutions) {
+    std::vector<int> matrix_check(matrix[0].size());
+    for (auto index : rows)
+      for (unsigned i = 0; i < matrix[index].size(); ++i)
+        matrix_check[i] += matrix[index][i];
+    EXPECT_EQ(std::vector<int>(matrix[0].size(), 1), matrix_check);
+  }
+}
+
+TEST(DlxTest, ParallelSolveTest) {
+  auto matrix = multiSolutionMatrix();
+  for (unsigned threads = 2; threads <= 4; ++threads) {
+    DLX dlx{matrix};
+    ASSERT_TRUE(dlx.solve(threads));
+    auto result = dlx.getSolution();
+    std::vector<int> matrix_check(matrix[0].size());
+    for (auto index : result)
+      for (unsigned i = 0; i < matrix[index].size(); ++i)
+        matrix_check[i] += matrix[index][i];
+    EXPECT_EQ(std::vector<int>(matrix[0].size(), 1), matrix_check);
+  }
+}
+
 std::vector<std::vector<int>> noSolutionMatrix() {
   /*
    * 0 0 0 0 0 0 1	[1]	[2]
@@ -172,4 +320,26 @@ TEST(DlxTest, NoSolutionTest) {
   auto result = dlx.getSolution();
   EXPECT_EQ(0, result.size()) << "Expected no solution (size ==0)!!!";
 }
+
+TEST(DlxTest, ParallelNoSolutionTest) {
+  DLX dlx{noSolutionMatrix()};
+  EXPECT_FALSE(dlx.solve(3));
+  EXPECT_EQ(0, dlx.getSolution().size());
+}
+
+TEST(DlxTest, ParallelStopTest) {
+  // every pair of 15 columns, an odd number can never be covered by pairs
+  const int n{15};
+  std::vector<std::vector<int>> rows{};
+  for (int i = 0; i < n; ++i)
+    for (int j = i + 1; j < n; ++j)
+      rows.push_back({i, j});
+  DLX dlx{n, rows};
+  auto stop = [](uint64_t nodes) { return nodes >= 5000; };
+  EXPECT_EQ(DLX::Status::Suspended, dlx.solve(2, stop));
+  EXPECT_GE(dlx.getNodeCount(), 5000);
+  EXPECT_EQ(0, dlx.getSolution().size());
+  DLX small{noSolutionMatrix()};
+  EXPECT_EQ(DLX::Status::Unsolvable, small.solve(2, stop));
+}
 } // namespace
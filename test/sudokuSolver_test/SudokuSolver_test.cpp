@@ -23,9 +23,16 @@
  */
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
+#include "Generator.hpp"
+#include "Propagator.hpp"
+#include "SolutionCache.hpp"
+#include "Solver.hpp"
 #include "SudokuSolver.hpp"
 
 namespace {
@@ -218,6 +225,208 @@ TEST(SudokuSolverTest, SimpleSudokuSolverTest) {
   }
 }
 
+TEST(SudokuSolverTest, CountSolutionTest) {
+  int **inputs = new int *[4] {};
+  for (int i = 0; i < 4; ++i)
+    inputs[i] = new int[4]{};
+  SudokuSolver empty(inputs, 4);
+  for (int i = 0; i < 4; ++i)
+    delete[] inputs[i];
+  delete[] inputs;
+  // every 4x4 sudoku grid
+  EXPECT_EQ(288, empty.countSolutions());
+  EXPECT_EQ(2, empty.countSolutions(2));
+  EXPECT_FALSE(empty.hasUniqueSolution());
+
+  SudokuSolver solver(sampleSudoku());
+  EXPECT_TRUE(solver.hasUniqueSolution());
+}
+
+TEST(SudokuSolverTest, SolutionLimitTest) {
+  Sudoku sudoku{"................"};
+  SudokuSolver solver(sudoku);
+  SudokuSolver::SSOptions options{};
+  options.max_solutions = 10;
+  options.max_stored = 3;
+  unsigned streamed{0};
+  options.on_solution = [&](const Sudoku &solution) {
+    Sudoku copy{solution};
+    EXPECT_TRUE(copy.isCorrect());
+    return ++streamed < 7;
+  };
+  auto result = solver.search(options);
+  EXPECT_EQ(7, streamed) << "sink should stop the search";
+  EXPECT_EQ(7, result.number_of_solution);
+  EXPECT_EQ(3, result.solutions.size());
+  for (auto solution : result.solutions)
+    EXPECT_TRUE(solution.isCorrect());
+}
+
+TEST(SudokuSolverTest, ParallelHexadokuTest) {
+  std::ifstream infile;
+  infile.open("sample/puzzle16_small", std::ifstream::in);
+  EXPECT_TRUE(infile.good()) << "FILE NOT EXIST";
+  std::string line{};
+  while (std::getline(infile, line)) {
+    Sudoku hexadoku{line};
+    SudokuSolver solver(hexadoku);
+    SudokuSolver::SSOptions options{};
+    options.threads = 4;
+    auto result = solver.search(options);
+    EXPECT_EQ(1, result.number_of_solution);
+    for (auto solution : result.solutions)
+      verifyResult(hexadoku, solution);
+  }
+  infile.close();
+}
+
+TEST(SudokuSolverTest, BudgetTest) {
+  Sudoku sudoku{std::string(256, '.')};
+  SudokuSolver solver(sudoku);
+  SudokuSolver::SSOptions options{};
+  options.max_solutions = 0;
+  options.max_stored = 0;
+  options.max_nodes = 10000;
+  auto result = solver.search(options);
+  EXPECT_EQ(SudokuSolver::SSResult::Status::OutOfNodes, result.status);
+  EXPECT_EQ(10000, result.statistics.nodes);
+  EXPECT_LT(0, result.number_of_solution);
+
+  options.max_nodes = 0;
+  options.deadline = std::chrono::steady_clock::now();
+  EXPECT_EQ(SudokuSolver::SSResult::Status::OutOfTime,
+            solver.search(options).status);
+
+  std::atomic<bool> cancel{true};
+  options.deadline = std::chrono::steady_clock::time_point::max();
+  options.cancel = &cancel;
+  EXPECT_EQ(SudokuSolver::SSResult::Status::Cancelled,
+            solver.search(options).status);
+
+  // budgets never cut a search that finishes in time
+  SudokuSolver small(sampleSudoku());
+  options.max_nodes = 1000000;
+  options.cancel = nullptr;
+  result = small.search(options);
+  EXPECT_EQ(SudokuSolver::SSResult::Status::Complete, result.status);
+  EXPECT_EQ(1, result.number_of_solution);
+}
+
+TEST(SudokuSolverTest, FixedSizeSolverTest) {
+  Sudoku sudoku = sampleSudoku();
+  Solver<9> solver{Board<9>{sudoku}};
+  ASSERT_TRUE(solver.solve());
+  const Board<9> &solution = solver.getSolution();
+  EXPECT_TRUE(solution.isCorrect());
+  for (int i = 0; i < 9; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      if (!sudoku.cellIsEmpty(i, j)) {
+        EXPECT_EQ(sudoku.getCell(i, j), solution.getCell(i, j));
+      }
+    }
+  }
+
+  // two 1s in the first row
+  Sudoku broken = sampleSudoku();
+  broken.setCell(0, 0, 1);
+  broken.setCell(0, 1, 1);
+  EXPECT_FALSE(Solver<9>{Board<9>{broken}}.solve());
+}
+
+TEST(SudokuSolverTest, PrunedExactCoverTest) {
+  // 1 at (0, 0) rules 1 out of its row, column and box, and every other
+  // digit out of its cell
+  Sudoku sudoku{"1..............."};
+  Board<4> puzzle{sudoku};
+  auto matrix = Solver<4>::exactCover(puzzle);
+  ASSERT_EQ(Solver<4>::num_rows, matrix.size());
+  int kept{0};
+  for (auto &row : matrix)
+    kept += row.empty() ? 0 : 1;
+  EXPECT_EQ(64 - 3 - 7, kept);
+  EXPECT_FALSE(matrix[Solver<4>::rowId(0, 0, 1)].empty());
+  EXPECT_TRUE(matrix[Solver<4>::rowId(0, 0, 2)].empty());
+  EXPECT_TRUE(matrix[Solver<4>::rowId(1, 1, 1)].empty());
+  EXPECT_FALSE(matrix[Solver<4>::rowId(2, 2, 1)].empty());
+  EXPECT_TRUE(Solver<4>{puzzle}.solve());
+  // a given too large for the grid has no row and no solution
+  puzzle.setCell(3, 3, 5);
+  matrix = Solver<4>::exactCover(puzzle);
+  for (int num = 1; num <= 4; ++num)
+    EXPECT_TRUE(matrix[Solver<4>::rowId(3, 3, num)].empty());
+  EXPECT_FALSE(Solver<4>{puzzle}.solve());
+}
+
+TEST(SudokuSolverTest, OtherSizeTest) {
+  // sizes without a Board<N> fall back to a search of run time size
+  const int size{36}, box{6};
+  std::vector<uint8_t> grid(size * size), puzzle{};
+  for (int i = 0; i < size; ++i)
+    for (int j = 0; j < size; ++j)
+      grid[i * size + j] =
+          static_cast<uint8_t>((i % box * box + i / box + j) % size + 1);
+  puzzle = grid;
+  for (int i = 0; i < size; ++i)
+    puzzle[i * size + i] = puzzle[i] = 0; // the diagonal and the first row
+  SudokuSolver solver(Sudoku{puzzle.data(), size});
+  auto result = solver.search();
+  ASSERT_EQ(1, result.number_of_solution);
+  EXPECT_TRUE(Sudoku(grid.data(), size) == result.solutions.front());
+  const uint8_t single_cell{0};
+  EXPECT_EQ(1, SudokuSolver(Sudoku{&single_cell, 1}).countSolutions());
+
+  // a size that is not a square has no boxes to solve
+  std::vector<uint8_t> six(36, 0);
+  result = SudokuSolver(Sudoku{six.data(), 6}).search();
+  EXPECT_EQ(SudokuSolver::SSResult::Status::BadSize, result.status);
+  EXPECT_EQ(0, result.number_of_solution);
+}
+
+TEST(SudokuSolverTest, SudokuXTest) {
+  Sudoku empty{"................"};
+  auto variant = SudokuSolver::Variant::sudokuX(4);
+  SudokuSolver solver(empty, variant);
+  SudokuSolver::SSOptions options{};
+  options.max_solutions = 0;
+  options.max_stored = 100;
+  auto result = solver.search(options);
+  EXPECT_EQ(48, result.number_of_solution);
+  for (auto solution : result.solutions) {
+    EXPECT_TRUE(solution.isCorrect());
+    for (auto &region : variant.regions) {
+      std::vector<bool> seen(5, false);
+      for (auto &cell : region) {
+        int num = solution.getCell(cell.first, cell.second);
+        EXPECT_FALSE(seen[num]) << num << " repeats on a diagonal";
+        seen[num] = true;
+      }
+    }
+  }
+}
+
+TEST(SudokuSolverTest, WindokuTest) {
+  auto variant = SudokuSolver::Variant::windoku(4);
+  ASSERT_EQ(1, variant.regions.size());
+  EXPECT_EQ(4, variant.regions[0].size());
+  EXPECT_EQ(4, SudokuSolver::Variant::windoku(9).regions.size());
+  SudokuSolver solver(Sudoku{"................"}, variant);
+  EXPECT_EQ(168, solver.countSolutions());
+}
+
+TEST(SudokuSolverTest, PartialRegionTest) {
+  // opposite corners differ, anti-diagonal holds every digit
+  SudokuSolver::Variant variant{};
+  variant.regions.push_back({{0, 0}, {3, 3}});
+  SudokuSolver corners(Sudoku{"................"}, variant);
+  EXPECT_EQ(216, corners.countSolutions());
+  variant.regions.push_back({{0, 3}, {1, 2}, {2, 1}, {3, 0}});
+  SudokuSolver both(Sudoku{"................"}, variant);
+  EXPECT_EQ(48, both.countSolutions());
+  // givens breaking a region leave no solution
+  SudokuSolver broken(Sudoku{"1..............1"}, variant);
+  EXPECT_EQ(0, broken.countSolutions());
+}
+
 TEST(SudokuSolverTest, SinglePuzzleTest) {
   // for some puzzle that gives error
   std::string input{".8..1......5....3.......4.....6.5.7.89....2.....3.....2..."
@@ -231,4 +440,194 @@ TEST(SudokuSolverTest, SinglePuzzleTest) {
     verifyResult(sudoku, solution);
   }
 }
+
+TEST(SudokuSolverTest, CacheTest) {
+  SolutionCache cache{2, 1};
+  SudokuSolver::SSOptions options{};
+  options.cache = &cache;
+  SudokuSolver solver(sampleSudoku());
+  auto first = solver.search(options);
+  auto second = solver.search(options);
+  ASSERT_EQ(1, second.number_of_solution);
+  EXPECT_EQ(first.solutions.front().toSimpleString(),
+            second.solutions.front().toSimpleString());
+  auto stats = cache.getStatistics();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+
+  // the solution limits are part of the key
+  options.max_solutions = 2;
+  EXPECT_EQ(1, solver.search(options).number_of_solution);
+  EXPECT_EQ(2, cache.getStatistics().misses);
+  // a third result pushes out the least recently used one
+  SudokuSolver other(simpleSudoku());
+  other.search(options);
+  stats = cache.getStatistics();
+  EXPECT_EQ(1, stats.evictions);
+  EXPECT_EQ(2, stats.size);
+
+  std::atomic<int> solved{0};
+  std::vector<std::thread> threads{};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 100; ++i) {
+        SudokuSolver repeated(simpleSudoku());
+        if (repeated.search(options).number_of_solution > 0)
+          ++solved;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  EXPECT_EQ(400, solved);
+  EXPECT_EQ(401, cache.getStatistics().hits);
+  // so are the settings the statistics depend on
+  options.bitboard = false;
+  other.search(options);
+  EXPECT_EQ(4, cache.getStatistics().misses);
+}
+
+TEST(SudokuSolverTest, PropagationTest) {
+  // singles alone solve the sample, so no search is needed
+  SudokuSolver solver(sampleSudoku());
+  SudokuSolver::SSOptions options{};
+  options.bitboard = false;
+  auto propagated = solver.search(options);
+  ASSERT_EQ(1, propagated.number_of_solution);
+  EXPECT_EQ(0, propagated.statistics.nodes);
+  options.propagate = false;
+  auto searched = solver.search(options);
+  ASSERT_EQ(1, searched.number_of_solution);
+  EXPECT_EQ(searched.solutions.front().toSimpleString(),
+            propagated.solutions.front().toSimpleString());
+
+  // a partial pass leaves every solution to the search
+  SudokuSolver::Variant variant{};
+  variant.regions.push_back({{0, 3}, {1, 2}, {2, 1}, {3, 0}});
+  SudokuSolver stuck(Sudoku{"1..............."}, variant);
+  options.max_solutions = 0;
+  const unsigned expected{stuck.search(options).number_of_solution};
+  EXPECT_GT(expected, 1);
+  options.propagate = true;
+  EXPECT_EQ(expected, stuck.search(options).number_of_solution);
+  // givens in the same row clash
+  SudokuSolver broken(Sudoku{"1..1............"});
+  EXPECT_EQ(0, broken.countSolutions());
+  // a hidden single takes the last candidate of a cell later in its unit
+  Sudoku emptied{"....43..66...81.7...46........1.792.......6..5...6....7.9.2."
+                 "......5.8.6.4.......5"};
+  Propagator<9> propagator{Board<9>{emptied}};
+  EXPECT_EQ(Propagator<9>::Outcome::Contradiction, propagator.run());
+}
+
+TEST(SudokuSolverTest, BitboardTest) {
+  // the bitboard search finds what the exact cover one does
+  std::ifstream infile("sample/puzzle9_small", std::ifstream::in);
+  ASSERT_TRUE(infile.good()) << "FILE NOT EXIST";
+  std::string line{};
+  SudokuSolver::SSOptions bitboard{}, exact_cover{};
+  bitboard.max_solutions = exact_cover.max_solutions = 2;
+  exact_cover.bitboard = false;
+  while (std::getline(infile, line)) {
+    SudokuSolver solver(Sudoku{line});
+    auto fast = solver.search(bitboard);
+    auto slow = solver.search(exact_cover);
+    ASSERT_EQ(slow.number_of_solution, fast.number_of_solution) << line;
+    for (size_t i = 0; i < fast.solutions.size(); ++i)
+      EXPECT_EQ(slow.solutions[i].toSimpleString(),
+                fast.solutions[i].toSimpleString());
+  }
+
+  // limits and budgets hold as for the exact cover search
+  SudokuSolver empty(Sudoku{std::string(81, '.')});
+  bitboard.max_solutions = 1000;
+  bitboard.max_stored = 0;
+  auto result = empty.search(bitboard);
+  EXPECT_EQ(1000, result.number_of_solution);
+  EXPECT_EQ(SudokuSolver::SSResult::Status::Complete, result.status);
+  bitboard.max_solutions = 0;
+  bitboard.max_nodes = 5000;
+  result = empty.search(bitboard);
+  EXPECT_EQ(SudokuSolver::SSResult::Status::OutOfNodes, result.status);
+  EXPECT_EQ(5000, result.statistics.nodes);
+  std::atomic<bool> cancel{true};
+  bitboard.max_nodes = 0;
+  bitboard.cancel = &cancel;
+  EXPECT_EQ(SudokuSolver::SSResult::Status::Cancelled,
+            empty.search(bitboard).status);
+  // givens in the same box clash
+  SudokuSolver broken(Sudoku{"1........" ".1......." + std::string(63, '.')});
+  EXPECT_EQ(0, broken.countSolutions());
+}
+
+TEST(SudokuSolverTest, PortfolioTest) {
+  SudokuSolver::SSOptions options{};
+  options.portfolio = 4;
+  Sudoku hexadoku = sampleHexadoku();
+  SudokuSolver solver(hexadoku);
+  auto result = solver.search(options);
+  ASSERT_EQ(1, result.number_of_solution);
+  EXPECT_TRUE(result.solutions.front().isCorrect());
+  verifyResult(hexadoku, result.solutions.front());
+
+  // shuffled searches move the regions along and map solutions back
+  auto variant = SudokuSolver::Variant::sudokuX(4);
+  SudokuSolver diagonal(Sudoku{"................"}, variant);
+  options.portfolio_seed = 7;
+  options.max_solutions = 0;
+  options.max_stored = 100;
+  result = diagonal.search(options);
+  EXPECT_EQ(48, result.number_of_solution);
+  for (auto solution : result.solutions) {
+    EXPECT_TRUE(solution.isCorrect());
+    for (auto &region : variant.regions) {
+      std::vector<bool> seen(5, false);
+      for (auto &cell : region) {
+        int num = solution.getCell(cell.first, cell.second);
+        EXPECT_FALSE(seen[num]) << num << " repeats on a diagonal";
+        seen[num] = true;
+      }
+    }
+  }
+
+  std::atomic<bool> cancel{true};
+  options.cancel = &cancel;
+  SudokuSolver empty(Sudoku{std::string(256, '.')});
+  EXPECT_EQ(SudokuSolver::SSResult::Status::Cancelled,
+            empty.search(options).status);
+}
+
+TEST(SudokuSolverTest, GeneratorTest) {
+  Generator generator{9, 7};
+  Sudoku grid = generator.grid();
+  EXPECT_TRUE(grid.isCorrect());
+  Sudoku puzzle = generator.dig(grid);
+  EXPECT_TRUE(SudokuSolver(puzzle).hasUniqueSolution());
+  // minimal: no clue can go
+  for (int i = 0; i < 9; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      if (puzzle.cellIsEmpty(i, j))
+        continue;
+      Sudoku fewer{puzzle};
+      fewer.setCell(i, j, 0);
+      EXPECT_FALSE(SudokuSolver(fewer).hasUniqueSolution())
+          << "clue at (" << i << ", " << j << ") is not needed";
+    }
+  }
+
+  // the same seed gives the same puzzles
+  Generator first{9, 42}, second{9, 42};
+  for (int k = 0; k < 5; ++k)
+    EXPECT_EQ(first.puzzle().toSimpleString(),
+              second.puzzle().toSimpleString());
+  Sudoku target = first.puzzle(40);
+  const std::string cells{target.toSimpleString()};
+  EXPECT_EQ(81 - 40, std::count(cells.begin(), cells.end(), '.'));
+  EXPECT_TRUE(SudokuSolver(target).hasUniqueSolution());
+
+  Generator hexadoku{16, 1};
+  Sudoku big = hexadoku.grid();
+  EXPECT_TRUE(big.isCorrect());
+  EXPECT_EQ(0, Generator(10).grid().getSize());
+}
 } // namespace
@@ -25,8 +25,16 @@
 #include "gtest/gtest.h"
 #include <fstream>
 #include <iostream>
-
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Board.hpp"
+#include "Canonical.hpp"
+#include "Parser.hpp"
+#include "PuzzleFile.hpp"
 #include "Sudoku.hpp"
+#include "Verifier.hpp"
 
 namespace {
 Sudoku sampleSudoku() {
@@ -300,6 +308,33 @@ TEST(SudokuTest, CopyConstructorTest) {
   EXPECT_FALSE(copy.isComplete()) << msg;
 }
 
+TEST(SudokuTest, MoveTest) {
+  static_assert(std::is_nothrow_move_constructible<Sudoku>::value,
+                "vector<Sudoku> should move on reallocation");
+  static_assert(std::is_nothrow_move_assignable<Sudoku>::value, "");
+  std::string puzzle{"1.3..2.4.3..4.2."};
+  Sudoku sudoku{puzzle};
+  Sudoku moved{std::move(sudoku)};
+  EXPECT_EQ(puzzle, moved.toSimpleString());
+  Sudoku assigned{std::string(81, '.')};
+  assigned = std::move(moved);
+  EXPECT_EQ(4, assigned.getSize());
+  EXPECT_EQ(puzzle, assigned.toSimpleString());
+  // a moved-from board can be assigned again
+  moved = assigned;
+  EXPECT_TRUE(moved == assigned);
+  // including from a board of the size it was left with
+  Sudoku taken{std::move(moved)};
+  Sudoku empty{std::string{}};
+  moved = empty;
+  EXPECT_EQ(0, moved.getSize());
+  assigned = std::move(taken);
+  taken = moved;
+  EXPECT_EQ(0, taken.getSize());
+  taken = assigned;
+  EXPECT_EQ(puzzle, taken.toSimpleString());
+}
+
 TEST(SudokuTest, HexadokuTest) {
   Sudoku hexadoku = sampleHexadoku();
   EXPECT_TRUE(hexadoku.isIncomplete());
@@ -379,6 +414,55 @@ TEST(SudokuTest, SimpleSudokuTest) {
   EXPECT_TRUE(sudoku.isSafe(3, 0, 4)) << "expect isSafe(3, 0, 4) return true";
 }
 
+TEST(SudokuTest, WriteStringTest) {
+  const std::string simple{"1.3..2.4.3..4.2."};
+  Sudoku sudoku{simple};
+  std::vector<char> buffer(Sudoku::maxStringLength(4));
+  char *end = sudoku.writeString(buffer.data());
+  EXPECT_EQ(buffer.size(), end - buffer.data()) << "4x4 drawings have one size";
+  EXPECT_EQ("+-----------+\n"
+            "| 1 X | 3 X |\n"
+            "| X 2 | X 4 |\n"
+            "|-----+-----|\n"
+            "| X 3 | X X |\n"
+            "| 4 X | 2 X |\n"
+            "+-----------+\n",
+            std::string(buffer.data(), end));
+  end = sudoku.writeSimpleString(buffer.data());
+  EXPECT_EQ(simple, std::string(buffer.data(), end));
+
+  Sudoku hexadoku = sampleHexadoku();
+  buffer.resize(Sudoku::maxStringLength(16));
+  end = hexadoku.writeString(buffer.data());
+  EXPECT_EQ(hexadoku.toString(), std::string(buffer.data(), end));
+  EXPECT_EQ(buffer.size(), end - buffer.data());
+}
+
+TEST(SudokuTest, CandidatesTest) {
+  Sudoku sudoku = simpleSudoku();
+  // (3, 0) sees 3 in its column and 1, 3 in its row
+  EXPECT_EQ(0xAu, sudoku.candidates(3, 0));
+  EXPECT_EQ(0u, sudoku.candidates(0, 1)) << "filled cell has no candidates";
+  sudoku.setCell(3, 0, 4);
+  EXPECT_FALSE(sudoku.isSafe(3, 3, 4));
+  sudoku.setCell(3, 0, 0);
+  EXPECT_TRUE(sudoku.isSafe(3, 3, 4));
+
+  // a repeated digit stays in the unit until both copies are gone
+  sudoku.setCell(3, 0, 1);
+  EXPECT_FALSE(sudoku.isSafe(3, 3, 1));
+  sudoku.setCell(3, 0, 0);
+  EXPECT_FALSE(sudoku.isSafe(3, 3, 1));
+  sudoku.setCell(3, 1, 0);
+  EXPECT_TRUE(sudoku.isSafe(3, 3, 1));
+
+  Sudoku complete = simpleCompleteSudoku();
+  EXPECT_TRUE(complete.isComplete());
+  complete.setCell(2, 2, 0);
+  EXPECT_TRUE(complete.isIncomplete());
+  EXPECT_EQ(0x2u, complete.candidates(2, 2));
+}
+
 TEST(SudokuTest, SimpleSudokuTest2) {
   Sudoku sudoku = simpleCompleteSudoku();
   EXPECT_TRUE(sudoku.isComplete());
@@ -423,4 +507,168 @@ TEST(SudokuTest, ToSimpleStringTest) {
   }
   infile.close();
 }
+
+TEST(SudokuTest, BoardTest) {
+  static_assert(Board<9>::box == 3 && Board<25>::box == 5, "box width");
+  Sudoku sudoku = simpleSudoku();
+  Board<4> board{sudoku};
+  EXPECT_EQ(2, board.getCell(0, 1));
+  EXPECT_EQ(3, Board<4>::boxOf(3, 3));
+  EXPECT_FALSE(board.isSafe(3, 0, 1));
+  EXPECT_TRUE(board.isSafe(3, 0, 2));
+  EXPECT_FALSE(board.isComplete());
+  EXPECT_EQ(sudoku.toSimpleString(), board.toSudoku().toSimpleString());
+
+  Sudoku complete = simpleCompleteSudoku();
+  Board<4> solved{complete};
+  EXPECT_TRUE(solved.isCorrect());
+  // a latin square whose boxes repeat digits
+  Sudoku latin{"1234234134124123"};
+  EXPECT_FALSE(Board<4>{latin}.isCorrect());
+}
+
+struct BoxWidth {
+  template <int N> int visit() { return Board<N>::box; }
+};
+
+TEST(SudokuTest, DispatchBoardSizeTest) {
+  BoxWidth box_width;
+  EXPECT_EQ(3, dispatchBoardSize(9, box_width, 0));
+  EXPECT_EQ(4, dispatchBoardSize(16, box_width, 0));
+  EXPECT_EQ(0, dispatchBoardSize(6, box_width, 0));
+}
+
+TEST(SudokuTest, VerifierTest) {
+  // a valid grid relabelled into 37 grids, two out of three then broken
+  const std::string valid{"123456789456789123789123456"
+                          "234567891567891234891234567"
+                          "345678912678912345912345678"};
+  std::vector<uint8_t> grids{};
+  std::vector<uint8_t> expected{};
+  for (int g = 0; g < 37; ++g) {
+    std::vector<uint8_t> grid{};
+    for (char c : valid)
+      grid.push_back(static_cast<uint8_t>((c - '1' + g) % 9 + 1));
+    if (g % 3 == 1)
+      std::swap(grid[g], grid[g + 1]); // repeats in two columns
+    if (g % 3 == 2)
+      grid[g] = 0;
+    EXPECT_EQ(g % 3 == 0, verifyGrid(9, grid.data()));
+    grids.insert(grids.end(), grid.begin(), grid.end());
+    expected.push_back(g % 3 == 0);
+  }
+  std::vector<uint8_t> ok(expected.size());
+  EXPECT_EQ(13, verifyGrids(9, grids.data(), expected.size(), ok.data()));
+  EXPECT_EQ(expected, ok);
+  EXPECT_EQ(0, verifyGrids(6, grids.data(), 2, ok.data()));
+
+  // the isCorrect() the verifier replaced accepted any grid of digits
+  Sudoku latin{"1234234134124123"};
+  EXPECT_FALSE(latin.isCorrect());
+}
+
+TEST(SudokuTest, ParserTest) {
+  uint8_t cells[max_puzzle_cells];
+  int size{0};
+  const std::string hexadoku{std::string(16, '.') + "0aBg" +
+                             std::string(236, '.') + " \r"};
+  ParseError error = parsePuzzle(
+      hexadoku.data(), hexadoku.data() + hexadoku.size(), cells, &size);
+  EXPECT_FALSE(error.failed());
+  EXPECT_EQ(16, size);
+  EXPECT_EQ(0, cells[16]);
+  EXPECT_EQ(10, cells[17]) << "lower case letters are digits too";
+  EXPECT_EQ(11, cells[18]);
+  EXPECT_EQ(16, cells[19]);
+
+  const std::string bad{"1.3..2.4.3x.4.2."};
+  error = parsePuzzle(bad.data(), bad.data() + bad.size(), cells, &size);
+  EXPECT_EQ(ParseError::Reason::BadCharacter, error.reason);
+  EXPECT_EQ(11, error.column);
+  const std::string large{"1.3..2.4.3..4.5."};
+  error = parsePuzzle(large.data(), large.data() + large.size(), cells, &size);
+  EXPECT_EQ(ParseError::Reason::DigitOutOfRange, error.reason);
+  EXPECT_EQ(15, error.column);
+
+  const std::string text{"1.3..2.4.3..4.2.\n\n123\r\n" + bad + "\n" +
+                         std::string(81, '.')};
+  std::vector<size_t> lines{};
+  std::vector<ParseError> errors{};
+  parsePuzzles(
+      text.data(), text.data() + text.size(),
+      [&](const uint8_t *, int size, size_t line) {
+        lines.push_back(line * 100 + size);
+      },
+      [&](const ParseError &error) { errors.push_back(error); });
+  EXPECT_EQ((std::vector<size_t>{104, 509}), lines);
+  ASSERT_EQ(2, errors.size());
+  EXPECT_EQ(ParseError::Reason::BadLength, errors[0].reason);
+  EXPECT_EQ(3, errors[0].line);
+  EXPECT_EQ(4, errors[1].line);
+  EXPECT_EQ(11, errors[1].column);
+
+  Sudoku rejected{bad};
+  EXPECT_EQ(0, rejected.getSize());
+}
+
+TEST(SudokuTest, PuzzleFileTest) {
+  std::vector<Sudoku> puzzles{};
+  std::ifstream infile;
+  infile.open("sample/puzzle16", std::ifstream::in);
+  ASSERT_TRUE(infile.good()) << "FILE NOT EXIST";
+  std::string line{};
+  while (std::getline(infile, line))
+    puzzles.emplace_back(line);
+  infile.close();
+  ASSERT_TRUE(PuzzleFile::write("puzzle16.sdk", puzzles));
+  EXPECT_TRUE(PuzzleFile::isPuzzleFile("puzzle16.sdk"));
+  EXPECT_FALSE(PuzzleFile::isPuzzleFile("sample/puzzle16"));
+
+  PuzzleFile file{};
+  ASSERT_TRUE(file.open("puzzle16.sdk"));
+  EXPECT_EQ(16, file.getSize());
+  ASSERT_EQ(puzzles.size(), file.getCount());
+  // read out of order through the index
+  for (size_t i = puzzles.size(); i-- > 0;)
+    EXPECT_EQ(puzzles[i].toSimpleString(), file.get(i).toSimpleString());
+  file.close();
+
+  puzzles.emplace_back(std::string(81, '.'));
+  EXPECT_FALSE(PuzzleFile::write("mixed.sdk", puzzles))
+      << "one file holds one size";
+  std::ofstream truncated("truncated.sdk", std::ofstream::binary);
+  // a header promising five 9x9 puzzles, and nothing after it
+  const char header[16]{'S', 'D', 'K', 'P', 1, 0, 9, 4, 5};
+  truncated.write(header, sizeof(header));
+  truncated.close();
+  EXPECT_FALSE(file.open("truncated.sdk"));
+}
+
+TEST(SudokuTest, CanonicalTest) {
+  Sudoku puzzle{sampleSudoku()};
+  Transform shuffle{Transform::identity(9)};
+  shuffle.transposed = true;
+  shuffle.rows = {{7, 6, 8, 3, 4, 5, 1, 0, 2}};
+  shuffle.cols = {{3, 5, 4, 0, 1, 2, 8, 7, 6}};
+  for (int num = 1; num <= 9; ++num)
+    shuffle.digits[num] = static_cast<uint8_t>(10 - num);
+  Sudoku shuffled{shuffle.apply(puzzle)};
+  EXPECT_FALSE(shuffled == puzzle);
+
+  Sudoku canonical{std::string{}}, other{std::string{}};
+  Transform transform{}, other_transform{};
+  ASSERT_TRUE(canonicalize(puzzle, canonical, transform));
+  ASSERT_TRUE(canonicalize(shuffled, other, other_transform));
+  EXPECT_EQ(canonical.toSimpleString(), other.toSimpleString());
+  Sudoku applied{transform.apply(puzzle)};
+  EXPECT_TRUE(applied == canonical);
+
+  // the solution of the canonical puzzle maps back to the original one
+  Sudoku solution{completeSudoku()};
+  Sudoku canonical_solution{transform.apply(solution)};
+  EXPECT_TRUE(canonical_solution.isCorrect());
+  EXPECT_TRUE(transform.revert(canonical_solution) == solution);
+  Sudoku hexadoku{sampleHexadoku()};
+  EXPECT_FALSE(canonicalize(hexadoku, canonical, transform));
+}
 } // namespace